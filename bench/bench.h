@@ -0,0 +1,308 @@
+#ifndef DEQUE_BENCH_BENCH_H
+#define DEQUE_BENCH_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <new>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define DEQUE_BENCH_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define DEQUE_BENCH_HAS_TSC 1
+#else
+#define DEQUE_BENCH_HAS_TSC 0
+#endif
+
+namespace bench
+{
+
+// Totals shared by every counting_allocator specialization, so that the map and the
+// blocks of a deque are accounted together. live_bytes is what is still allocated and
+// is not cleared by reset().
+struct alloc_stats
+{
+    std::size_t bytes = 0;
+    std::size_t calls = 0;
+    std::size_t live_bytes = 0;
+
+    void reset() noexcept
+    {
+        bytes = 0;
+        calls = 0;
+    }
+};
+
+inline alloc_stats stats;
+
+template <class T>
+struct counting_allocator
+{
+    using value_type = T;
+
+    counting_allocator() noexcept = default;
+
+    template <class U>
+    counting_allocator(counting_allocator<U> const &) noexcept
+    {
+    }
+
+    T *allocate(std::size_t n)
+    {
+        stats.bytes += n * sizeof(T);
+        stats.live_bytes += n * sizeof(T);
+        ++stats.calls;
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept
+    {
+        stats.live_bytes -= n * sizeof(T);
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template <class U>
+    friend bool operator==(counting_allocator const &, counting_allocator<U> const &) noexcept
+    {
+        return true;
+    }
+};
+
+// An element of exactly N bytes whose first word carries the value used by the
+// benchmarks, so that operations on it cannot be folded away.
+template <std::size_t N>
+struct payload
+{
+    static_assert(N >= sizeof(std::uint32_t));
+
+    std::uint32_t value;
+    unsigned char pad[N - sizeof(std::uint32_t)];
+
+    payload() noexcept = default;
+
+    payload(std::uint32_t v) noexcept : value(v)
+    {
+        std::memset(pad, static_cast<unsigned char>(v), sizeof(pad));
+    }
+
+    friend bool operator==(payload const &lhs, payload const &rhs) noexcept
+    {
+        return lhs.value == rhs.value;
+    }
+
+    friend auto operator<=>(payload const &lhs, payload const &rhs) noexcept
+    {
+        return lhs.value <=> rhs.value;
+    }
+};
+
+template <>
+struct payload<sizeof(std::uint32_t)>
+{
+    std::uint32_t value;
+
+    payload() noexcept = default;
+
+    payload(std::uint32_t v) noexcept : value(v)
+    {
+    }
+
+    friend bool operator==(payload const &lhs, payload const &rhs) noexcept
+    {
+        return lhs.value == rhs.value;
+    }
+
+    friend auto operator<=>(payload const &lhs, payload const &rhs) noexcept
+    {
+        return lhs.value <=> rhs.value;
+    }
+};
+
+template <class T>
+inline void do_not_optimize(T const &value) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    auto volatile sink = &value;
+    (void)sink;
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// The time stamp counter, which ticks at the nominal clock rate of the processor, or 0
+// where there is none.
+inline std::uint64_t cycle_counter() noexcept
+{
+#if DEQUE_BENCH_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Deterministic indices for the random access benchmarks.
+struct lcg
+{
+    std::uint64_t state;
+
+    std::uint32_t operator()() noexcept
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<std::uint32_t>(state >> 33);
+    }
+};
+
+struct timing
+{
+    double ns;
+    std::size_t alloc_bytes;
+    std::size_t alloc_calls;
+};
+
+// Runs setup() and then body() `repeat` times and returns the fastest body() together
+// with the allocations body() made. Only body() is timed; setup() is not counted.
+template <class Setup, class Body>
+inline timing best_of(std::size_t repeat, Setup setup, Body body)
+{
+    using clock = std::chrono::steady_clock;
+    auto best = std::chrono::nanoseconds::max();
+    timing t{};
+    for (std::size_t i = 0; i != repeat; ++i)
+    {
+        auto state = setup();
+        stats.reset();
+        auto const start = clock::now();
+        body(state);
+        auto const stop = clock::now();
+        t.alloc_bytes = stats.bytes;
+        t.alloc_calls = stats.calls;
+        do_not_optimize(state);
+        best = (std::min)(best, std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start));
+    }
+    t.ns = static_cast<double>(best.count());
+    return t;
+}
+
+struct result
+{
+    char const *container;
+    char const *operation;
+    std::size_t element_size;
+    std::size_t size;
+    double ns_per_op;
+    std::size_t alloc_bytes;
+    std::size_t alloc_calls;
+};
+
+// The memory held by one container of `elements` elements, averaged over many of them.
+struct footprint
+{
+    char const *container;
+    std::size_t element_size;
+    std::size_t elements;
+    double bytes;
+    double allocations;
+};
+
+// The cost of one operation in a tight loop, for the index benchmarks.
+struct latency
+{
+    char const *container;
+    char const *operation;
+    std::size_t element_size;
+    std::size_t size;
+    double ns;
+    double cycles;
+};
+
+// Items passed through a concurrent container by `threads` threads, for the concurrent
+// benchmarks.
+struct throughput
+{
+    char const *container;
+    char const *operation;
+    std::size_t element_size;
+    std::size_t threads;
+    std::size_t items;
+    double ns_per_item;
+};
+
+class report
+{
+    std::FILE *out_;
+
+  public:
+    explicit report(std::FILE *out) noexcept : out_(out)
+    {
+    }
+
+    void section(char const *title) const noexcept
+    {
+        std::fprintf(out_, "\n## %s\n\n", title);
+        std::fprintf(out_, "%-16s %-16s %6s %9s %12s %14s %10s\n", "container", "operation", "elem", "size", "ns/op",
+                     "alloc_bytes", "allocs");
+    }
+
+    void add(result const &r) const noexcept
+    {
+        std::fprintf(out_, "%-16s %-16s %6zu %9zu %12.3f %14zu %10zu\n", r.container, r.operation, r.element_size,
+                     r.size, r.ns_per_op, r.alloc_bytes, r.alloc_calls);
+        std::fflush(out_);
+    }
+
+    void footprint_section(char const *title) const noexcept
+    {
+        std::fprintf(out_, "\n## %s\n\n", title);
+        std::fprintf(out_, "%-16s %6s %9s %14s %12s\n", "container", "elem", "elements", "bytes", "allocations");
+    }
+
+    void add(footprint const &f) const noexcept
+    {
+        std::fprintf(out_, "%-16s %6zu %9zu %14.1f %12.2f\n", f.container, f.element_size, f.elements, f.bytes,
+                     f.allocations);
+        std::fflush(out_);
+    }
+
+    void latency_section(char const *title) const noexcept
+    {
+        std::fprintf(out_, "\n## %s\n\n", title);
+        std::fprintf(out_, "%-16s %-16s %6s %9s %12s %12s\n", "container", "operation", "elem", "size", "ns/op",
+                     "cycles/op");
+    }
+
+    void add(latency const &l) const noexcept
+    {
+        std::fprintf(out_, "%-16s %-16s %6zu %9zu %12.3f %12.2f\n", l.container, l.operation, l.element_size, l.size,
+                     l.ns, l.cycles);
+        std::fflush(out_);
+    }
+
+    void throughput_section(char const *title) const noexcept
+    {
+        std::fprintf(out_, "\n## %s\n\n", title);
+        std::fprintf(out_, "%-20s %-16s %6s %7s %9s %12s %12s\n", "container", "operation", "elem", "threads", "items",
+                     "ns/item", "Mitems/s");
+    }
+
+    void add(throughput const &t) const noexcept
+    {
+        std::fprintf(out_, "%-20s %-16s %6zu %7zu %9zu %12.3f %12.2f\n", t.container, t.operation, t.element_size,
+                     t.threads, t.items, t.ns_per_item, 1e3 / t.ns_per_item);
+        std::fflush(out_);
+    }
+
+    void note(char const *text) const noexcept
+    {
+        std::fprintf(out_, "%s\n", text);
+    }
+};
+
+} // namespace bench
+
+#endif // DEQUE_BENCH_BENCH_H
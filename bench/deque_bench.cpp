@@ -0,0 +1,621 @@
+#include "bench.h"
+#include "deque.hpp"
+#include "deque_algorithms.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+template <class T>
+using bizwen_deque = bizwen::deque<T, bench::counting_allocator<T>>;
+
+template <class T>
+using std_deque = std::deque<T, bench::counting_allocator<T>>;
+
+template <class T>
+using std_vector = std::vector<T, bench::counting_allocator<T>>;
+
+inline constexpr std::size_t sizes[] = {1024, 16384, 262144};
+
+inline constexpr std::size_t compare_size = std::size_t{1} << 20;
+
+// Fewer of the larger elements, so that each container stays at 64 MiB.
+template <std::size_t N>
+inline constexpr std::size_t large_size = (std::size_t{1} << 26) / N;
+
+// Enough repetitions that small sizes are not dominated by timer resolution, while
+// keeping the largest containers to a handful of runs.
+constexpr std::size_t repeat_for(std::size_t n) noexcept
+{
+    auto const r = (std::size_t{1} << 22) / n;
+    return r < 3 ? 3 : (r > 50 ? 50 : r);
+}
+
+template <class C>
+C filled(std::size_t n)
+{
+    using T = typename C::value_type;
+    C c;
+    for (std::size_t i = 0; i != n; ++i)
+        c.push_back(T(static_cast<std::uint32_t>(i)));
+    return c;
+}
+
+// The values 0, ..., n - 1 in a fixed pseudo-random order.
+template <class C>
+C shuffled(std::size_t n)
+{
+    using T = typename C::value_type;
+    std::vector<std::uint32_t> values(n);
+    for (std::size_t i = 0; i != n; ++i)
+        values[i] = static_cast<std::uint32_t>(i);
+    bench::lcg next{n};
+    for (std::size_t i = n; i > 1; --i)
+        std::swap(values[i - 1], values[next() % i]);
+    C c;
+    for (auto v : values)
+        c.push_back(T(v));
+    return c;
+}
+
+template <class C>
+C shifted(std::size_t n)
+{
+    using T = typename C::value_type;
+    if constexpr (requires(C &c) { c.pop_front(); })
+    {
+        C c;
+        c.push_back(T{});
+        for (std::size_t i = 0; i != n; ++i)
+            c.push_back(T(static_cast<std::uint32_t>(i)));
+        c.pop_front();
+        return c;
+    }
+    else
+        return filled<C>(n);
+}
+
+template <class T>
+std::vector<T> source(std::size_t n)
+{
+    std::vector<T> v;
+    v.reserve(n);
+    for (std::size_t i = 0; i != n; ++i)
+        v.push_back(T(static_cast<std::uint32_t>(i)));
+    return v;
+}
+
+template <class C, class R>
+void append(C &c, R const &r)
+{
+    if constexpr (requires { c.append_range(r); })
+        c.append_range(r);
+    else
+        c.insert(c.end(), r.begin(), r.end());
+}
+
+template <class C, class R>
+void prepend(C &c, R const &r)
+{
+    if constexpr (requires { c.prepend_range(r); })
+        c.prepend_range(r);
+    else
+        c.insert(c.begin(), r.begin(), r.end());
+}
+
+template <class C, class R>
+void insert_middle(C &c, R const &r)
+{
+    auto const pos = c.begin() + static_cast<std::ptrdiff_t>(c.size() / 2);
+    if constexpr (requires { c.insert_range(pos, r); })
+        c.insert_range(pos, r);
+    else
+        c.insert(pos, r.begin(), r.end());
+}
+
+// bizwen::copy where it takes the iterators, so that bizwen::deque goes block by block.
+template <class I, class O>
+O copy_elements(I first, I last, O out)
+{
+    if constexpr (requires { bizwen::copy(first, last, out); })
+        return bizwen::copy(first, last, out);
+    else
+        return std::copy(first, last, out);
+}
+
+// Whether the element holding v is among the `percent` percent that are purged. The
+// multiplicative hash scatters them so that the branch cannot be predicted.
+constexpr bool purged(std::uint32_t v, std::uint32_t percent) noexcept
+{
+    return (v * 2654435761u >> 16) % 100 < percent;
+}
+
+// std::erase_if for the standard containers, found by ADL for bizwen::deque.
+template <class C, class P>
+std::size_t erase_elements_if(C &c, P pred)
+{
+    using std::erase_if;
+    return erase_if(c, pred);
+}
+
+template <class C>
+class runner
+{
+    using T = typename C::value_type;
+
+    bench::report const &out_;
+    char const *name_;
+    std::size_t n_;
+
+    template <class Setup, class Body>
+    void run(char const *operation, std::size_t ops, Setup setup, Body body) const
+    {
+        run(operation, ops, repeat_for(n_), setup, body);
+    }
+
+    template <class Setup, class Body>
+    void run(char const *operation, std::size_t ops, std::size_t repeat, Setup setup, Body body) const
+    {
+        auto const t = bench::best_of(repeat, setup, body);
+        out_.add({name_, operation, sizeof(T), n_, t.ns / static_cast<double>(ops), t.alloc_bytes, t.alloc_calls});
+    }
+
+  public:
+    runner(bench::report const &out, char const *name, std::size_t n) noexcept : out_(out), name_(name), n_(n)
+    {
+    }
+
+    void push_back() const
+    {
+        run("push_back", n_, [] { return C{}; }, [n = n_](C &c) {
+            for (std::size_t i = 0; i != n; ++i)
+                c.push_back(T(static_cast<std::uint32_t>(i)));
+        });
+    }
+
+    void push_front() const
+    {
+        if constexpr (requires(C &c) { c.push_front(T{}); })
+        {
+            run("push_front", n_, [] { return C{}; }, [n = n_](C &c) {
+                for (std::size_t i = 0; i != n; ++i)
+                    c.push_front(T(static_cast<std::uint32_t>(i)));
+            });
+        }
+    }
+
+    void pop_back() const
+    {
+        run("pop_back", n_, [n = n_] { return filled<C>(n); }, [](C &c) {
+            while (!c.empty())
+                c.pop_back();
+        });
+    }
+
+    void pop_front() const
+    {
+        if constexpr (requires(C &c) { c.pop_front(); })
+        {
+            run("pop_front", n_, [n = n_] { return filled<C>(n); }, [](C &c) {
+                while (!c.empty())
+                    c.pop_front();
+            });
+        }
+    }
+
+    // A queue of n elements that is fed at the back and drained at the front.
+    void fifo() const
+    {
+        if constexpr (requires(C &c) { c.pop_front(); })
+        {
+            run("fifo", 4 * n_, [n = n_] { return filled<C>(n); }, [n = n_](C &c) {
+                for (std::size_t i = 0; i != 4 * n; ++i)
+                {
+                    c.push_back(T(static_cast<std::uint32_t>(i)));
+                    c.pop_front();
+                }
+            });
+        }
+    }
+
+    void random_access() const
+    {
+        struct state
+        {
+            C c;
+            std::vector<std::size_t> index;
+        };
+        run(
+            "operator[]", n_,
+            [n = n_] {
+                bench::lcg next{n};
+                std::vector<std::size_t> index(n);
+                for (auto &i : index)
+                    i = next() % n;
+                return state{filled<C>(n), std::move(index)};
+            },
+            [](state &s) {
+                std::uint32_t sum = 0;
+                for (auto i : s.index)
+                    sum += s.c[i].value;
+                bench::do_not_optimize(sum);
+            });
+    }
+
+    // Sorting is dominated by iterator arithmetic and comparisons, so only a few are done.
+    void sort() const
+    {
+        run("std::sort", n_, 3, [n = n_] { return shuffled<C>(n); }, [](C &c) { std::sort(c.begin(), c.end()); });
+    }
+
+    // The sorts of bizwen::deque against the generic ones over the same container.
+    void sort_all() const
+    {
+        this->sort();
+        run("std::stable_sort", n_, 3, [n = n_] { return shuffled<C>(n); },
+            [](C &c) { std::stable_sort(c.begin(), c.end()); });
+        if constexpr (requires(C &c) { bizwen::sort(c); })
+        {
+            run("bizwen::sort", n_, 3, [n = n_] { return shuffled<C>(n); }, [](C &c) { bizwen::sort(c); });
+            run("bizwen::stable_sort", n_, 3, [n = n_] { return shuffled<C>(n); },
+                [](C &c) { bizwen::stable_sort(c); });
+        }
+    }
+
+    void lower_bound() const
+    {
+        struct state
+        {
+            C c;
+            std::vector<std::uint32_t> keys;
+        };
+        auto const setup = [n = n_] {
+            bench::lcg next{n};
+            std::vector<std::uint32_t> keys(n);
+            for (auto &k : keys)
+                k = static_cast<std::uint32_t>(next() % n);
+            return state{filled<C>(n), std::move(keys)};
+        };
+        run("std::lower_bound", n_, setup, [](state &s) {
+            std::size_t sum = 0;
+            for (auto k : s.keys)
+                sum += static_cast<std::size_t>(std::lower_bound(s.c.begin(), s.c.end(), T(k)) - s.c.begin());
+            bench::do_not_optimize(sum);
+        });
+        if constexpr (requires(C &c) { bizwen::lower_bound(c.begin(), c.end(), T{}); })
+        {
+            run("bizwen::lower_bound", n_, setup, [](state &s) {
+                std::size_t sum = 0;
+                for (auto k : s.keys)
+                    sum += static_cast<std::size_t>(bizwen::lower_bound(s.c.begin(), s.c.end(), T(k)) - s.c.begin());
+                bench::do_not_optimize(sum);
+            });
+        }
+    }
+
+    void distance() const
+    {
+        struct state
+        {
+            C c;
+            std::vector<std::size_t> index;
+        };
+        run(
+            "distance", n_,
+            [n = n_] {
+                bench::lcg next{n};
+                std::vector<std::size_t> index(n);
+                for (auto &i : index)
+                    i = next() % n;
+                return state{filled<C>(n), std::move(index)};
+            },
+            [](state &s) {
+                std::ptrdiff_t sum = 0;
+                auto const first = s.c.begin();
+                for (auto i : s.index)
+                    sum += std::distance(first + static_cast<std::ptrdiff_t>(i), s.c.end());
+                bench::do_not_optimize(sum);
+            });
+    }
+
+    void iterate() const
+    {
+        run("iterate", n_, [n = n_] { return filled<C>(n); }, [](C &c) {
+            std::uint32_t sum = 0;
+            for (auto const &e : c)
+                sum += e.value;
+            bench::do_not_optimize(sum);
+        });
+    }
+
+    void iterate_segments() const
+    {
+        if constexpr (requires(C &c) { c.segments(); })
+        {
+            run("iterate_segments", n_, [n = n_] { return filled<C>(n); }, [](C &c) {
+                std::uint32_t sum = 0;
+                for (auto segment : c.segments())
+                    for (auto const &e : segment)
+                        sum += e.value;
+                bench::do_not_optimize(sum);
+            });
+        }
+    }
+
+    // Each middle insertion or erasure is linear in the size, so only a few are done.
+    void middle_insert() const
+    {
+        auto const k = std::size_t{32};
+        run("insert_middle", k, 3, [n = n_] { return filled<C>(n); }, [k](C &c) {
+            for (std::size_t i = 0; i != k; ++i)
+                c.insert(c.begin() + static_cast<std::ptrdiff_t>(c.size() / 2), T(static_cast<std::uint32_t>(i)));
+        });
+    }
+
+    void middle_erase() const
+    {
+        auto const k = std::size_t{32};
+        run("erase_middle", k, 3, [n = n_] { return filled<C>(n); }, [k](C &c) {
+            for (std::size_t i = 0; i != k; ++i)
+                c.erase(c.begin() + static_cast<std::ptrdiff_t>(c.size() / 2));
+        });
+    }
+
+    void append_range() const
+    {
+        struct state
+        {
+            C c;
+            std::vector<T> src;
+        };
+        run("append_range", n_, [n = n_] { return state{C{}, source<T>(n)}; },
+            [](state &s) { append(s.c, s.src); });
+    }
+
+    // Prepends n elements in front of n existing ones.
+    void prepend_range() const
+    {
+        struct state
+        {
+            C c;
+            std::vector<T> src;
+        };
+        run("prepend_range", n_, [n = n_] { return state{filled<C>(n), source<T>(n)}; },
+            [](state &s) { prepend(s.c, s.src); });
+    }
+
+    void insert_range() const
+    {
+        struct state
+        {
+            C c;
+            std::vector<T> src;
+        };
+        auto const k = n_ / 8;
+        run("insert_range", k, [n = n_, k] { return state{filled<C>(n), source<T>(k)}; },
+            [](state &s) { insert_middle(s.c, s.src); });
+    }
+
+    void copy() const
+    {
+        struct state
+        {
+            C from;
+            C to;
+        };
+        run("copy", n_, [n = n_] { return state{filled<C>(n), filled<C>(n)}; },
+            [](state &s) { bench::do_not_optimize(copy_elements(s.from.begin(), s.from.end(), s.to.begin())); });
+    }
+
+    // Copy-assigns over a container that already holds as many elements.
+    void copy_assign() const
+    {
+        struct state
+        {
+            C from;
+            C to;
+        };
+        run("copy_assign", n_, [n = n_] { return state{filled<C>(n), filled<C>(n)}; },
+            [](state &s) { s.to = s.from; });
+    }
+
+    void copy_to_buffer() const
+    {
+        struct state
+        {
+            C from;
+            std::vector<T> to;
+        };
+        run("copy_to_buffer", n_, [n = n_] { return state{filled<C>(n), source<T>(n)}; },
+            [](state &s) { bench::do_not_optimize(copy_elements(s.from.begin(), s.from.end(), s.to.data())); });
+    }
+
+    void copy_from_buffer() const
+    {
+        struct state
+        {
+            std::vector<T> from;
+            C to;
+        };
+        run("copy_from_buffer", n_, [n = n_] { return state{source<T>(n), filled<C>(n)}; },
+            [](state &s) {
+                auto const first = s.from.data();
+                bench::do_not_optimize(copy_elements(first, first + s.from.size(), s.to.begin()));
+            });
+    }
+
+    // Two equal containers, so that every element is compared. In the second one the
+    // elements start one slot further into their block where the container allows it.
+    void equal() const
+    {
+        struct state
+        {
+            C a;
+            C b;
+        };
+        run("operator==", n_, [n = n_] { return state{filled<C>(n), shifted<C>(n)}; },
+            [](state &s) { bench::do_not_optimize(s.a == s.b); });
+    }
+
+    // The containers differ only in their last element.
+    void three_way() const
+    {
+        struct state
+        {
+            C a;
+            C b;
+        };
+        run(
+            "operator<=>", n_,
+            [n = n_] {
+                state s{filled<C>(n), shifted<C>(n)};
+                s.b.back() = T(static_cast<std::uint32_t>(n + 1));
+                return s;
+            },
+            [](state &s) { bench::do_not_optimize(s.a <=> s.b); });
+    }
+
+    void compare() const
+    {
+        equal();
+        three_way();
+    }
+
+    // Purges `percent` percent of the elements, through erase_if and through the generic
+    // remove_if followed by erase.
+    void purge(std::uint32_t percent) const
+    {
+        auto const pred = [percent](T const &e) { return purged(e.value, percent); };
+        run("erase_if", n_, 3, [n = n_] { return filled<C>(n); },
+            [pred](C &c) { bench::do_not_optimize(erase_elements_if(c, pred)); });
+        run("remove_if+erase", n_, 3, [n = n_] { return filled<C>(n); },
+            [pred](C &c) { c.erase(std::remove_if(c.begin(), c.end(), pred), c.end()); });
+    }
+
+    void all() const
+    {
+        push_back();
+        push_front();
+        pop_back();
+        pop_front();
+        fifo();
+        random_access();
+        sort();
+        lower_bound();
+        distance();
+        iterate();
+        iterate_segments();
+        middle_insert();
+        middle_erase();
+        append_range();
+        prepend_range();
+        insert_range();
+        copy();
+        copy_assign();
+        copy_to_buffer();
+        copy_from_buffer();
+    }
+};
+
+template <std::size_t N>
+void run_element(bench::report const &out)
+{
+    using T = bench::payload<N>;
+    for (auto n : sizes)
+    {
+        runner<bizwen_deque<T>>(out, "bizwen::deque", n).all();
+        runner<std_deque<T>>(out, "std::deque", n).all();
+        runner<std_vector<T>>(out, "std::vector", n).all();
+    }
+}
+
+// Plain integers rather than bench::payload, whose comparisons look at one member only
+// and so cannot be done a chunk at a time.
+template <class T>
+void run_compare(bench::report const &out)
+{
+    runner<bizwen_deque<T>>(out, "bizwen::deque", compare_size).compare();
+    runner<std_deque<T>>(out, "std::deque", compare_size).compare();
+    runner<std_vector<T>>(out, "std::vector", compare_size).compare();
+}
+
+template <std::size_t N>
+void run_purge(bench::report const &out, std::uint32_t percent)
+{
+    using T = bench::payload<N>;
+    runner<bizwen_deque<T>>(out, "bizwen::deque", large_size<N>).purge(percent);
+    runner<std_deque<T>>(out, "std::deque", large_size<N>).purge(percent);
+    runner<std_vector<T>>(out, "std::vector", large_size<N>).purge(percent);
+}
+
+template <std::size_t N>
+void run_sort(bench::report const &out)
+{
+    using T = bench::payload<N>;
+    runner<bizwen_deque<T>>(out, "bizwen::deque", large_size<N>).sort_all();
+    runner<std_deque<T>>(out, "std::deque", large_size<N>).sort_all();
+    runner<std_vector<T>>(out, "std::vector", large_size<N>).sort_all();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::FILE *file = stdout;
+    if (argc > 1)
+    {
+        file = std::fopen(argv[1], "w");
+        if (file == nullptr)
+        {
+            std::perror(argv[1]);
+            return 1;
+        }
+    }
+
+    bench::report out(file);
+#ifndef NDEBUG
+    out.note("warning: assertions are enabled, configure with -DCMAKE_BUILD_TYPE=Release for meaningful numbers");
+#endif
+    out.note("ns/op is the best of several runs; alloc_bytes and allocs are per run of the whole operation.");
+
+    out.section("4-byte elements");
+    run_element<4>(out);
+    out.section("16-byte elements");
+    run_element<16>(out);
+    out.section("64-byte elements");
+    run_element<64>(out);
+    out.section("256-byte elements");
+    run_element<256>(out);
+
+    out.section("Comparison of 1M bytes");
+    run_compare<unsigned char>(out);
+    out.section("Comparison of 1M 32-bit integers");
+    run_compare<std::uint32_t>(out);
+    out.section("Comparison of 1M 64-bit integers");
+    run_compare<std::uint64_t>(out);
+
+    out.section("Purge of 30% of 16M 4-byte elements");
+    run_purge<4>(out, 30);
+    out.section("Purge of 70% of 16M 4-byte elements");
+    run_purge<4>(out, 70);
+    out.section("Purge of 30% of 1M 64-byte elements");
+    run_purge<64>(out, 30);
+    out.section("Purge of 70% of 1M 64-byte elements");
+    run_purge<64>(out, 70);
+
+    out.section("Sort of 16M 4-byte elements");
+    run_sort<4>(out);
+    out.section("Sort of 1M 64-byte elements");
+    run_sort<64>(out);
+
+    if (file != stdout)
+        std::fclose(file);
+    return 0;
+}
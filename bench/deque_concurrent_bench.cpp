@@ -0,0 +1,123 @@
+#include "bench.h"
+#include "deque.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+
+inline constexpr std::size_t items = std::size_t{1} << 22;
+
+inline constexpr std::size_t repeat = 5;
+
+// The usual alternative to a concurrent queue: a container behind a mutex.
+template <class C>
+class locked
+{
+    using T = typename C::value_type;
+
+    std::mutex mutex_;
+    C c_;
+
+  public:
+    using value_type = T;
+
+    void push_back(T const &value)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        c_.push_back(value);
+    }
+
+    bool try_pop_front(T &value)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (c_.empty())
+            return false;
+        value = c_.front();
+        c_.pop_front();
+        return true;
+    }
+};
+
+// One producer thread pushes `items` elements while the calling thread pops them. The
+// time runs from the start of the producer to the last pop, the best of `repeat` runs.
+template <class Q>
+double producer_consumer()
+{
+    using T = typename Q::value_type;
+    using clock = std::chrono::steady_clock;
+    auto best = std::chrono::nanoseconds::max();
+    for (std::size_t r = 0; r != repeat; ++r)
+    {
+        Q q;
+        auto const start = clock::now();
+        std::thread producer([&q] {
+            for (std::size_t i = 0; i != items; ++i)
+                q.push_back(T(static_cast<std::uint32_t>(i)));
+        });
+        T value{};
+        std::uint32_t sum = 0;
+        for (std::size_t popped = 0; popped != items;)
+        {
+            if (q.try_pop_front(value))
+            {
+                sum += value.value;
+                ++popped;
+            }
+        }
+        auto const stop = clock::now();
+        producer.join();
+        bench::do_not_optimize(sum);
+        best = (std::min)(best, std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start));
+    }
+    return static_cast<double>(best.count()) / static_cast<double>(items);
+}
+
+template <std::size_t N>
+void run_spsc(bench::report const &out)
+{
+    using T = bench::payload<N>;
+    out.add(bench::throughput{"bizwen::spsc_deque", "push/pop", sizeof(T), 2, items,
+                              producer_consumer<bizwen::spsc_deque<T>>()});
+    out.add(bench::throughput{"locked bizwen::deque", "push/pop", sizeof(T), 2, items,
+                              producer_consumer<locked<bizwen::deque<T>>>()});
+    out.add(bench::throughput{"locked std::deque", "push/pop", sizeof(T), 2, items,
+                              producer_consumer<locked<std::deque<T>>>()});
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::FILE *file = stdout;
+    if (argc > 1)
+    {
+        file = std::fopen(argv[1], "w");
+        if (file == nullptr)
+        {
+            std::perror(argv[1]);
+            return 1;
+        }
+    }
+
+    bench::report out(file);
+#ifndef NDEBUG
+    out.note("warning: assertions are enabled, configure with -DCMAKE_BUILD_TYPE=Release for meaningful numbers");
+#endif
+    out.note("ns/item is the wall time of a run divided by the items passed through, the best of several runs.");
+
+    out.throughput_section("One producer, one consumer, 4-byte elements");
+    run_spsc<4>(out);
+    out.throughput_section("One producer, one consumer, 64-byte elements");
+    run_spsc<64>(out);
+
+    if (file != stdout)
+        std::fclose(file);
+    return 0;
+}
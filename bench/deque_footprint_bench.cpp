@@ -0,0 +1,151 @@
+#include "bench.h"
+#include "deque.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "count_new.h"
+
+// A 4-byte element whose deques start with blocks of 16 elements and double them up
+// to the full block of bench::payload<4>.
+struct adaptive_payload : bench::payload<4>
+{
+    using payload::payload;
+};
+
+namespace bizwen
+{
+template <>
+struct deque_block_traits<adaptive_payload>
+{
+    static constexpr std::size_t block_elements = deque_block_traits<bench::payload<4>>::block_elements;
+    static constexpr std::size_t min_block_elements = 16;
+};
+} // namespace bizwen
+
+namespace
+{
+
+inline constexpr std::size_t element_counts[] = {0, 1, 2, 4, 8, 16, 64, 256, 1024, 4096};
+
+inline constexpr std::size_t sizes[] = {1024, 16384, 262144, 4194304};
+
+template <class T>
+using bizwen_deque = bizwen::deque<T, bench::counting_allocator<T>>;
+
+template <class T>
+using small_deque = bizwen::small_deque<T, 8, bench::counting_allocator<T>>;
+
+template <class T>
+using std_deque = std::deque<T, bench::counting_allocator<T>>;
+
+template <class T>
+using std_vector = std::vector<T, bench::counting_allocator<T>>;
+
+// Builds `count` containers of `elements` elements each and reports what one of them
+// holds on the heap: bytes through the allocator, allocations through count_new.h.
+template <class C>
+void footprint(bench::report const &out, char const *name, std::size_t elements)
+{
+    using T = typename C::value_type;
+    auto const count = elements < 1024 ? std::size_t{16384} : std::size_t{1024};
+
+    std::vector<C> all;
+    all.reserve(count);
+    auto const bytes = bench::stats.live_bytes;
+    auto const allocations = globalMemCounter.outstanding_new;
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        auto &c = all.emplace_back();
+        for (std::size_t j = 0; j != elements; ++j)
+            c.push_back(T(static_cast<std::uint32_t>(j)));
+    }
+    auto const held = static_cast<double>(bench::stats.live_bytes - bytes);
+    auto const made = static_cast<double>(globalMemCounter.outstanding_new - allocations);
+    out.add(bench::footprint{name, sizeof(T), elements, held / static_cast<double>(count),
+                             made / static_cast<double>(count)});
+}
+
+template <class C>
+C chain(std::size_t n)
+{
+    using T = typename C::value_type;
+    // Sattolo's algorithm: a random permutation made of a single cycle, so that following
+    // it from any element visits all of them.
+    std::vector<std::uint32_t> next(n);
+    for (std::size_t i = 0; i != n; ++i)
+        next[i] = static_cast<std::uint32_t>(i);
+    bench::lcg random{n};
+    for (std::size_t i = n - 1; i > 0; --i)
+        std::swap(next[i], next[random() % i]);
+    C c;
+    for (auto i : next)
+        c.push_back(T(i));
+    return c;
+}
+
+// Each index depends on the element read before it, so the loads cannot overlap and
+// ns/op is the latency of one operator[].
+template <class C>
+void pointer_chase(bench::report const &out, char const *name, std::size_t n)
+{
+    using T = typename C::value_type;
+    auto const t = bench::best_of(
+        5, [n] { return chain<C>(n); },
+        [n](C &c) {
+            std::uint32_t i = 0;
+            for (std::size_t k = 0; k != n; ++k)
+                i = c[i].value;
+            bench::do_not_optimize(i);
+        });
+    out.add({name, "pointer_chase", sizeof(T), n, t.ns / static_cast<double>(n), t.alloc_bytes, t.alloc_calls});
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::FILE *file = stdout;
+    if (argc > 1)
+    {
+        file = std::fopen(argv[1], "w");
+        if (file == nullptr)
+        {
+            std::perror(argv[1]);
+            return 1;
+        }
+    }
+
+    bench::report out(file);
+#ifndef NDEBUG
+    out.note("warning: assertions are enabled, configure with -DCMAKE_BUILD_TYPE=Release for meaningful numbers");
+#endif
+    out.note("bytes and allocations are what one container holds on the heap, averaged over many of them.");
+
+    using fixed = bench::payload<4>;
+    out.footprint_section("Footprint, 4-byte elements");
+    for (auto elements : element_counts)
+    {
+        footprint<bizwen_deque<fixed>>(out, "bizwen::deque", elements);
+        footprint<bizwen_deque<adaptive_payload>>(out, "adaptive", elements);
+        footprint<small_deque<fixed>>(out, "small_deque<8>", elements);
+        footprint<std_deque<fixed>>(out, "std::deque", elements);
+    }
+
+    out.section("Random access latency, 4-byte elements");
+    for (auto n : sizes)
+    {
+        pointer_chase<bizwen_deque<fixed>>(out, "bizwen::deque", n);
+        pointer_chase<bizwen_deque<adaptive_payload>>(out, "adaptive", n);
+        pointer_chase<std_deque<fixed>>(out, "std::deque", n);
+        pointer_chase<std_vector<fixed>>(out, "std::vector", n);
+    }
+
+    if (file != stdout)
+        std::fclose(file);
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include "bench.h"
+#include "deque.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+namespace
+{
+
+inline constexpr std::size_t sizes[] = {4096, 262144};
+
+inline constexpr std::size_t repeat = 20;
+
+template <class C>
+C filled(std::size_t n)
+{
+    using T = typename C::value_type;
+    C c;
+    for (std::size_t i = 0; i != n; ++i)
+        c.push_back(T(static_cast<std::uint32_t>(i)));
+    return c;
+}
+
+template <class C>
+class runner
+{
+    using T = typename C::value_type;
+
+    bench::report const &out_;
+    char const *name_;
+    C c_;
+    std::vector<std::size_t> index_;
+
+    // Runs body() `repeat` times and reports the fastest run per index.
+    template <class Body>
+    void run(char const *operation, Body body) const
+    {
+        using clock = std::chrono::steady_clock;
+        auto best_ns = std::chrono::nanoseconds::max();
+        auto best_cycles = ~std::uint64_t{0};
+        for (std::size_t i = 0; i != repeat; ++i)
+        {
+            auto const start = clock::now();
+            auto const first = bench::cycle_counter();
+            bench::do_not_optimize(body());
+            auto const last = bench::cycle_counter();
+            auto const stop = clock::now();
+            best_ns = (std::min)(best_ns, std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start));
+            best_cycles = (std::min)(best_cycles, last - first);
+        }
+        auto const n = static_cast<double>(index_.size());
+        out_.add(bench::latency{name_, operation, sizeof(T), c_.size(), static_cast<double>(best_ns.count()) / n,
+                                static_cast<double>(best_cycles) / n});
+    }
+
+  public:
+    runner(bench::report const &out, char const *name, std::size_t n)
+        : out_(out), name_(name), c_(filled<C>(n)), index_(n)
+    {
+        bench::lcg next{n};
+        for (auto &i : index_)
+            i = next() % n;
+    }
+
+    void subscript() const
+    {
+        run("operator[]", [this] {
+            std::uint32_t sum = 0;
+            for (auto i : index_)
+                sum += c_[i].value;
+            return sum;
+        });
+    }
+
+    // Moves one iterator by random steps forwards and backwards.
+    void advance() const
+    {
+        run("iterator+=", [this] {
+            std::uint32_t sum = 0;
+            auto it = c_.begin();
+            std::ptrdiff_t at = 0;
+            for (auto i : index_)
+            {
+                auto const to = static_cast<std::ptrdiff_t>(i);
+                it += to - at;
+                at = to;
+                sum += it->value;
+            }
+            return sum;
+        });
+    }
+
+    void distance() const
+    {
+        run("iterator-", [this] {
+            std::ptrdiff_t sum = 0;
+            auto const first = c_.begin();
+            for (auto i : index_)
+                sum += c_.end() - (first + static_cast<std::ptrdiff_t>(i));
+            return sum;
+        });
+    }
+
+    void all() const
+    {
+        subscript();
+        advance();
+        distance();
+    }
+};
+
+template <std::size_t N>
+void run_element(bench::report const &out)
+{
+    using T = bench::payload<N>;
+    for (auto n : sizes)
+    {
+        runner<bizwen::deque<T>>(out, "bizwen::deque", n).all();
+        runner<std::deque<T>>(out, "std::deque", n).all();
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::FILE *file = stdout;
+    if (argc > 1)
+    {
+        file = std::fopen(argv[1], "w");
+        if (file == nullptr)
+        {
+            std::perror(argv[1]);
+            return 1;
+        }
+    }
+
+    bench::report out(file);
+#ifndef NDEBUG
+    out.note("warning: assertions are enabled, configure with -DCMAKE_BUILD_TYPE=Release for meaningful numbers");
+#endif
+#if DEQUE_BENCH_HAS_TSC
+    out.note("cycles/op counts time stamp counter ticks, at the nominal clock rate of the processor.");
+#else
+    out.note("there is no time stamp counter on this target, cycles/op is 0.");
+#endif
+
+    // 12 bytes does not divide a 4096-byte block evenly, 4 and 64 do.
+    out.latency_section("4-byte elements");
+    run_element<4>(out);
+    out.latency_section("12-byte elements");
+    run_element<12>(out);
+    out.latency_section("64-byte elements");
+    run_element<64>(out);
+
+    if (file != stdout)
+        std::fclose(file);
+    return 0;
+}
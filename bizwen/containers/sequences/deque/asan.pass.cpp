@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+//  Under AddressSanitizer every slot of a block that holds no element is
+//  poisoned, both before the first element and after the last one, and so are
+//  blocks kept for reuse. The checks below run after each kind of operation
+//  and reduce to nothing in other builds.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+
+// An int whose deques grow their blocks from 4 elements up to 64.
+struct Adaptive {
+  int value;
+
+  Adaptive(int v = 0) : value(v) {}
+
+  operator int() const { return value; }
+};
+
+namespace bizwen {
+template <>
+struct deque_block_traits<Adaptive> {
+  static constexpr std::size_t block_elements     = 64;
+  static constexpr std::size_t min_block_elements = 4;
+};
+} // namespace bizwen
+
+#if TEST_HAS_FEATURE(address_sanitizer)
+extern "C" int __asan_address_is_poisoned(void const volatile* addr);
+
+// The slots just outside the elements are poisoned unless they lie outside
+// the block, whose extent is taken from the deque since blocks may differ in
+// size.
+template <class C>
+void check_dead_slots(const C& c) {
+  if (c.empty())
+    return;
+  typename C::const_iterator last = c.end() - 1;
+  const auto back                 = c.block_extent(last);
+  if (&*last + 1 != back.data() + back.size())
+    assert(__asan_address_is_poisoned(&*last + 1));
+  typename C::const_iterator first = c.begin();
+  const auto front                 = c.block_extent(first);
+  if (&*first != front.data())
+    assert(__asan_address_is_poisoned(&*first - 1));
+}
+#else
+template <class C>
+void check_dead_slots(const C&) {}
+#endif
+
+template <class C>
+void check(const C& c) {
+  assert(is_double_ended_contiguous_container_asan_correct(c));
+  check_dead_slots(c);
+}
+
+template <class C>
+void test() {
+  const int b = deque_block_elements<C>();
+  C c;
+  check(c);
+
+  for (int i = 0; i < 2 * b + 3; ++i) {
+    c.push_back(i);
+    check(c);
+  }
+  for (int i = 0; i < 2 * b + 3; ++i) {
+    c.push_front(-i);
+    check(c);
+  }
+  for (int i = 0; i < b + 1; ++i) {
+    c.pop_back();
+    check(c);
+    c.pop_front();
+    check(c);
+  }
+
+  c.insert(c.begin() + static_cast<int>(c.size()) / 2, 3, 7);
+  check(c);
+  c.erase(c.begin() + 1, c.begin() + 4);
+  check(c);
+  c.emplace(c.end() - 2, 9);
+  check(c);
+
+  std::vector<int> v(3 * b, 5);
+  c.insert(c.begin() + 1, v.begin(), v.end());
+  check(c);
+  c.erase(c.begin(), c.begin() + b);
+  check(c);
+
+  c.resize(c.size() + b + 1);
+  check(c);
+  c.resize(b / 2 + 1);
+  check(c);
+
+  c.reserve_back(3 * b);
+  check(c);
+  c.reserve_front(3 * b);
+  check(c);
+  c.shrink_to_fit();
+  check(c);
+
+  c.assign(2 * b + 1, 4);
+  check(c);
+  c.assign(3, 2);
+  check(c);
+
+  c.clear();
+  check(c);
+  c.assign(2 * b + 1, 5);
+  c.clear_keep_capacity();
+  check(c);
+  c.push_front(1);
+  check(c);
+  c.release();
+  check(c);
+
+  C d(c);
+  check(d);
+  d = C(5 * b, 1);
+  check(d);
+  d.swap(c);
+  check(c);
+  check(d);
+}
+
+int main(int, char**) {
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<char> >();
+  test<bizwen::deque<block_int<16> > >();
+  test<bizwen::deque<block_int<1> > >();
+  test<bizwen::deque<Adaptive> >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<int, min_allocator<int> > >();
+#endif
+
+  return 0;
+}
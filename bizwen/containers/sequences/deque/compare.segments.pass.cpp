@@ -0,0 +1,216 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// UNSUPPORTED: c++03, c++11, c++14, c++17
+
+// "deque.hpp"
+
+// template<class T, class Allocator>
+//   bool operator==(const deque<T, Allocator>& x, const deque<T, Allocator>& y);
+// template<class T, class Allocator>
+//   synth-three-way-result<T> operator<=>(const deque<T, Allocator>& x,
+//                                         const deque<T, Allocator>& y);
+
+//  Both walk the two deques one pair of contiguous chunks at a time, whatever
+//  the offsets of their first elements in their blocks. Bytes, and integers
+//  whose object representation is their value, are compared a chunk at a time;
+//  any other type, including floating point and types with padding, goes
+//  through its own operator== and operator<=>.
+
+#include "deque.hpp"
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+
+// Equal whatever the case of the letters, so equal elements may differ in
+// their bytes.
+struct NoCase {
+  char c;
+
+  NoCase(int v = 0) : c(static_cast<char>('a' + v % 26)) {}
+
+  static char lower(char x) { return x >= 'A' && x <= 'Z' ? static_cast<char>(x - 'A' + 'a') : x; }
+
+  friend bool operator==(NoCase x, NoCase y) { return lower(x.c) == lower(y.c); }
+  friend std::strong_ordering operator<=>(NoCase x, NoCase y) { return lower(x.c) <=> lower(y.c); }
+};
+
+// Has padding between its members, whose bytes take part in no comparison.
+struct Padded {
+  char c;
+  int i;
+
+  Padded(int v = 0) {
+    std::memset(static_cast<void*>(this), 0, sizeof(*this));
+    c = static_cast<char>(v);
+    i = v;
+  }
+
+  friend bool operator==(const Padded&, const Padded&) = default;
+  friend auto operator<=>(const Padded&, const Padded&) = default;
+};
+
+static_assert(!std::has_unique_object_representations_v<Padded>, "");
+
+template <class T>
+T value(int i) {
+  return T(i % 97);
+}
+
+template <>
+std::byte value<std::byte>(int i) {
+  return std::byte(static_cast<unsigned char>(i));
+}
+
+// Pairs lo < hi chosen so that comparing their bytes in memory order gives
+// the wrong answer for signed types and for multi-byte little-endian ones.
+template <class T>
+std::vector<std::pair<T, T> > ordered_pairs() {
+  std::vector<std::pair<T, T> > p;
+  if constexpr (std::is_same_v<T, bool>) {
+    p.push_back({false, true});
+  } else if constexpr (std::is_same_v<T, std::byte>) {
+    p.push_back({std::byte(1), std::byte(0xff)});
+  } else if constexpr (std::is_arithmetic_v<T>) {
+    p.push_back({T(0), T(1)});
+    if constexpr (std::is_signed_v<T>)
+      p.push_back({T(-1), T(1)});
+    if constexpr (sizeof(T) > 1)
+      p.push_back({T(1), T(256)});
+    p.push_back({T(1), std::numeric_limits<T>::max()});
+  } else {
+    p.push_back({T(1), T(2)});
+  }
+  return p;
+}
+
+// The deques agree with std::vector holding the same elements, for every
+// placement of the two in their blocks.
+template <class C>
+void check(const std::vector<typename C::value_type>& va, const std::vector<typename C::value_type>& vb) {
+  const int b     = deque_block_elements<C>();
+  int starts[]    = {0, 1, b / 2, b - 1};
+  const auto want = va <=> vb;
+  for (int sa : starts) {
+    for (int sb : starts) {
+      const C a = make_deque<C>(va, sa);
+      const C c = make_deque<C>(vb, sb);
+      assert((a == c) == (va == vb));
+      assert((a != c) == (va != vb));
+      assert((a <=> c) == want);
+      assert((a < c) == (va < vb));
+      assert((c < a) == (vb < va));
+      assert((a <= c) == (va <= vb));
+      assert((a >= c) == (va >= vb));
+    }
+  }
+}
+
+template <class C>
+void testN(int N) {
+  typedef typename C::value_type T;
+  const int b = deque_block_elements<C>();
+  std::vector<T> base;
+  for (int i = 0; i < N; ++i)
+    base.push_back(value<T>(i));
+  check<C>(base, base);
+
+  int positions[] = {0, 1, b - 1, b, b + 1, N / 2, N - 1};
+  for (int p : positions) {
+    if (p < 0 || p >= N)
+      continue;
+    for (const auto& lh : ordered_pairs<T>()) {
+      std::vector<T> va = base;
+      std::vector<T> vb = base;
+      va[p]             = lh.first;
+      vb[p]             = lh.second;
+      assert(va < vb);
+      check<C>(va, vb);
+      check<C>(vb, va);
+    }
+    // One is a prefix of the other.
+    std::vector<T> prefix(base.begin(), base.begin() + p);
+    check<C>(prefix, base);
+    check<C>(base, prefix);
+  }
+}
+
+template <class C>
+void test() {
+  const int b = deque_block_elements<C>();
+  int rng[]   = {0, 1, b - 1, b, b + 1, 3 * b + 5};
+  for (int N : rng)
+    testN<C>(N);
+}
+
+// Elements that compare equal with different bytes, or unequal with the same
+// bytes.
+template <class C>
+void test_floating() {
+  typedef typename C::value_type T;
+  const int b = deque_block_elements<C>();
+  std::vector<T> va(2 * b + 3, T(1));
+  std::vector<T> vb = va;
+  va[b]             = T(0.0);
+  vb[b]             = -T(0.0);
+  check<C>(va, vb);
+  assert(make_deque<C>(va, 0) == make_deque<C>(vb, 1));
+
+  va[b + 1] = std::numeric_limits<T>::quiet_NaN();
+  vb        = va;
+  check<C>(va, vb);
+  const C a = make_deque<C>(va, 1);
+  assert(!(a == a));
+  assert((a <=> a) == std::partial_ordering::unordered);
+}
+
+void test_class_types() {
+  typedef bizwen::deque<NoCase> C;
+  std::vector<NoCase> va(5000, NoCase(3));
+  std::vector<NoCase> vb = va;
+  for (std::size_t i = 0; i < vb.size(); i += 3)
+    vb[i].c = static_cast<char>(vb[i].c - 'a' + 'A');
+  check<C>(va, vb);
+  assert(make_deque<C>(va, 0) == make_deque<C>(vb, 7));
+
+  typedef bizwen::deque<Padded> P;
+  std::vector<Padded> pa(3000, Padded(5));
+  std::vector<Padded> pb = pa;
+  for (Padded& x : pb)
+    std::memset(reinterpret_cast<unsigned char*>(&x) + 1, 0xff, offsetof(Padded, i) - 1);
+  check<P>(pa, pb);
+  assert(make_deque<P>(pa, 0) == make_deque<P>(pb, 3));
+}
+
+int main(int, char**) {
+  test<bizwen::deque<char> >();
+  test<bizwen::deque<signed char> >();
+  test<bizwen::deque<unsigned char> >();
+  test<bizwen::deque<std::byte> >();
+  test<bizwen::deque<bool> >();
+  test<bizwen::deque<unsigned short> >();
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<unsigned> >();
+  test<bizwen::deque<long long> >();
+  test<bizwen::deque<double> >();
+  test<bizwen::deque<block_int<16> > >();
+  test<bizwen::deque<NoCase> >();
+  test<bizwen::deque<Padded> >();
+  test_floating<bizwen::deque<double> >();
+  test_floating<bizwen::deque<float> >();
+  test_class_types();
+
+  return 0;
+}
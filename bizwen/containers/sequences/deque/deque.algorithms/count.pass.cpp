@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque_algorithms.hpp"
+
+// template <class InputIterator, class T>
+//   typename iterator_traits<InputIterator>::difference_type
+//   count(InputIterator first, InputIterator last, const T& value);
+// template <class InputIterator, class Predicate>
+//   typename iterator_traits<InputIterator>::difference_type
+//   count_if(InputIterator first, InputIterator last, Predicate pred);
+
+//  Overloads for deque iterators that count one contiguous segment at a time.
+
+#include "deque_algorithms.hpp"
+#include "deque.hpp"
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <vector>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+#include "test_iterators.h"
+
+template <class C>
+void testN(int start, int N) {
+  typedef typename C::difference_type D;
+  typedef random_access_iterator<const int*> RI;
+  const C c = make_deque<C>(N, start, [](int i) { return i % 13; });
+  const std::vector<int> v(c.begin(), c.end());
+  int values[]  = {-1, 0, 5, 12, 13};
+  for_each_subrange(N, [&](int f, int l) {
+    for (int x : values) {
+      ASSERT_SAME_TYPE(decltype(bizwen::count(c.begin(), c.end(), x)), D);
+      const D n = bizwen::count(c.begin() + f, c.begin() + l, x);
+      assert(n == std::count(RI(v.data() + f), RI(v.data() + l), x));
+      assert(bizwen::count(c.cbegin() + f, c.cbegin() + l, x) == n);
+
+      const D np = bizwen::count_if(c.begin() + f, c.begin() + l, [x](int y) { return y < x; });
+      assert(np == std::count_if(RI(v.data() + f), RI(v.data() + l), [x](int y) { return y < x; }));
+    }
+  });
+}
+
+template <class C>
+void test() {
+  for_each_deque_shape(testN<C>);
+}
+
+int main(int, char**) {
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<block_int<16> > >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<int, min_allocator<int> > >();
+#endif
+
+  return 0;
+}
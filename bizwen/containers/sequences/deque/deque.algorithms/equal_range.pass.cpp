@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// UNSUPPORTED: c++03, c++11, c++14, c++17
+
+// "deque_algorithms.hpp"
+
+// template <class ForwardIterator, class T>
+//   pair<ForwardIterator, ForwardIterator>
+//   equal_range(ForwardIterator first, ForwardIterator last, const T& value);
+// template <class ForwardIterator, class T, class Compare>
+//   pair<ForwardIterator, ForwardIterator>
+//   equal_range(ForwardIterator first, ForwardIterator last, const T& value, Compare comp);
+
+//  Searches for both ends in two steps, as lower_bound and upper_bound do,
+//  sharing the search over the first elements of the blocks until the two
+//  ends fall apart.
+
+#include "deque_algorithms.hpp"
+#include "deque.hpp"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#include "test_macros.h"
+#include "counting_predicates.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+#include "test_iterators.h"
+
+// A key of another type than the elements.
+struct Key {
+  int value;
+};
+
+// Compares an element with a Key in either order.
+template <class T>
+struct KeyLess {
+  bool operator()(const T& e, Key key) const { return e < key.value; }
+  bool operator()(Key key, const T& e) const { return key.value < e; }
+};
+
+template <class C>
+void testN(int start, int N) {
+  typedef typename C::value_type T;
+  typedef typename C::const_iterator CI;
+  typedef random_access_iterator<const int*> RI;
+  const int b = deque_block_elements<C>();
+  const C c   = make_deque<C>(N, start, [](int i) { return i / 3; });
+  const std::vector<int> v(c.begin(), c.end());
+  const int bound = 2 * std::bit_width(static_cast<unsigned>(N)) + 2;
+
+  int offsets[] = {0, 1, b - 1, b, b + 1, N / 2, N - 1, N};
+  int keys[]    = {-1, 0, (b - 1) / 3, b / 3, (b + 1) / 3, N / 6, (N - 1) / 3, N / 3 + 1};
+  for (int f : offsets) {
+    for (int l : offsets) {
+      if (f < 0 || l > N || f > l)
+        continue;
+      for (int k : keys) {
+        const std::pair<RI, RI> r = std::equal_range(RI(v.data() + f), RI(v.data() + l), k);
+        const std::pair<CI, CI> i = bizwen::equal_range(c.begin() + f, c.begin() + l, T(k));
+        assert(i.first - c.begin() == base(r.first) - v.data());
+        assert(i.second - c.begin() == base(r.second) - v.data());
+
+        int count = 0;
+        const std::pair<CI, CI> j =
+            bizwen::equal_range(c.begin() + f, c.begin() + l, Key{k}, counting_predicate(KeyLess<T>(), count));
+        assert(j == i);
+        assert(count <= 2 * bound);
+      }
+    }
+  }
+}
+
+template <class C>
+void test() {
+  for_each_deque_shape(testN<C>);
+}
+
+int main(int, char**) {
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<block_int<1> > >();
+  test<bizwen::deque<block_int<16> > >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<int, min_allocator<int> > >();
+#endif
+
+  return 0;
+}
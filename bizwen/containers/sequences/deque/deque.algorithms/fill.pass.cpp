@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque_algorithms.hpp"
+
+// template <class ForwardIterator, class T>
+//   void fill(ForwardIterator first, ForwardIterator last, const T& value);
+// template <class OutputIterator, class Size, class T>
+//   OutputIterator fill_n(OutputIterator first, Size n, const T& value);
+
+//  Overloads for deque iterators that fill one contiguous segment at a time.
+
+#include "asan_testing.h"
+#include "deque_algorithms.hpp"
+#include "deque.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+#include "test_iterators.h"
+
+// Not trivially copyable, so the segments are filled element by element.
+struct Assignable {
+  int value;
+
+  Assignable(int v = 0) : value(v) {}
+  Assignable(const Assignable& other) : value(other.value) {}
+  Assignable& operator=(const Assignable& other) {
+    value = other.value;
+    return *this;
+  }
+
+  operator int() const { return value; }
+};
+
+namespace bizwen {
+template <>
+struct deque_block_traits<Assignable> {
+  static constexpr std::size_t block_elements = 16;
+};
+} // namespace bizwen
+
+// c, which held model, has had [f, l) set to x.
+template <class C>
+void check(const C& c, const std::vector<int>& model, int f, int l, int x) {
+  assert(c.size() == model.size());
+  for (int i = 0; i < static_cast<int>(model.size()); ++i)
+    assert(c[i] == (i >= f && i < l ? x : model[i]));
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+template <class C>
+void testN(int start, int N) {
+  typedef typename C::iterator I;
+  typedef random_access_iterator<int*> RI;
+  const C c0 = make_deque<C>(N, start, [](int i) { return i % 13; });
+  const std::vector<int> model(c0.begin(), c0.end());
+  for_each_subrange(N, [&](int f, int l) {
+    {
+      C c = c0;
+      bizwen::fill(c.begin() + f, c.begin() + l, 42);
+      check(c, model, f, l, 42);
+
+      std::vector<int> v = model;
+      std::fill(RI(v.data() + f), RI(v.data() + l), 42);
+      assert(std::equal(c.begin(), c.end(), v.begin(), v.end()));
+    }
+    {
+      C c = c0;
+      I i = bizwen::fill_n(c.begin() + f, l - f, -3);
+      assert(i == c.begin() + l);
+      check(c, model, f, l, -3);
+
+      C d = c0;
+      assert(bizwen::fill_n(d.begin() + f, static_cast<long long>(l - f), -3) == d.begin() + l);
+      assert(c == d);
+    }
+  });
+
+  // A count that is not positive fills nothing.
+  C c = c0;
+  assert(bizwen::fill_n(c.begin(), 0, 9) == c.begin());
+  assert(bizwen::fill_n(c.begin(), -5, 9) == c.begin());
+  check(c, model, 0, 0, 9);
+}
+
+template <class C>
+void test() {
+  for_each_deque_shape(testN<C>);
+}
+
+int main(int, char**) {
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<block_int<16> > >();
+  test<bizwen::deque<Assignable> >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<int, min_allocator<int> > >();
+#endif
+
+  return 0;
+}
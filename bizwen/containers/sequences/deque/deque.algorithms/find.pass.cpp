@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque_algorithms.hpp"
+
+// template <class InputIterator, class T>
+//   InputIterator find(InputIterator first, InputIterator last, const T& value);
+// template <class InputIterator, class Predicate>
+//   InputIterator find_if(InputIterator first, InputIterator last, Predicate pred);
+
+//  Overloads for deque iterators that search one contiguous segment at a time
+//  and return what std::find and std::find_if return.
+
+#include "deque_algorithms.hpp"
+#include "deque.hpp"
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+#include "test_iterators.h"
+
+template <class C>
+void testN(int start, int N) {
+  typedef typename C::const_iterator CI;
+  typedef random_access_iterator<const int*> RI;
+  const C c = make_deque<C>(N, start, [](int i) { return i % 13; });
+  const std::vector<int> v(c.begin(), c.end());
+  int values[]  = {-1, 0, 5, 12, 13};
+  for_each_subrange(N, [&](int f, int l) {
+    for (int x : values) {
+      const RI r = std::find(RI(v.data() + f), RI(v.data() + l), x);
+      const CI i = bizwen::find(c.begin() + f, c.begin() + l, x);
+      assert(i - c.begin() == base(r) - v.data());
+      assert(bizwen::find(c.cbegin() + f, c.cbegin() + l, x) == i);
+
+      const RI rp = std::find_if(RI(v.data() + f), RI(v.data() + l), [x](int y) { return y >= x; });
+      const CI ip = bizwen::find_if(c.begin() + f, c.begin() + l, [x](int y) { return y >= x; });
+      assert(ip - c.begin() == base(rp) - v.data());
+    }
+  });
+}
+
+template <class C>
+void test() {
+  for_each_deque_shape(testN<C>);
+}
+
+int main(int, char**) {
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<block_int<16> > >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<int, min_allocator<int> > >();
+#endif
+
+  // The iterator returned for a hit can be written through.
+  bizwen::deque<int> c           = make_deque<bizwen::deque<int> >(3000, 1000, [](int i) { return i % 13; });
+  bizwen::deque<int>::iterator i = bizwen::find(c.begin(), c.end(), 7);
+  *i = -7;
+  assert(c[7] == -7);
+
+  return 0;
+}
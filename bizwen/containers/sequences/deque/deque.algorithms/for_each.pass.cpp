@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque_algorithms.hpp"
+
+// template <class InputIterator, class Function>
+//   Function for_each(InputIterator first, InputIterator last, Function f);
+
+//  An overload for deque iterators that calls f on each element of one
+//  contiguous segment at a time, in order, and returns f.
+
+#include "asan_testing.h"
+#include "deque_algorithms.hpp"
+#include "deque.hpp"
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+#include "test_iterators.h"
+
+// Records what it sees and increments it.
+struct Visitor {
+  std::vector<int>* seen;
+  int calls;
+
+  explicit Visitor(std::vector<int>* s) : seen(s), calls(0) {}
+
+  template <class T>
+  void operator()(T& x) {
+    seen->push_back(x);
+    ++calls;
+    x = x + 1;
+  }
+};
+
+template <class C>
+void testN(int start, int N) {
+  typedef random_access_iterator<int*> RI;
+  const C c0 = make_deque<C>(N, start, [](int i) { return i % 13; });
+  const std::vector<int> model(c0.begin(), c0.end());
+  for_each_subrange(N, [&](int f, int l) {
+    C c = c0;
+    std::vector<int> seen;
+    Visitor r = bizwen::for_each(c.begin() + f, c.begin() + l, Visitor(&seen));
+    assert(r.calls == l - f);
+    assert(std::equal(seen.begin(), seen.end(), model.begin() + f, model.begin() + l));
+
+    std::vector<int> v = model;
+    std::vector<int> ignored;
+    std::for_each(RI(v.data() + f), RI(v.data() + l), Visitor(&ignored));
+    assert(std::equal(c.begin(), c.end(), v.begin(), v.end()));
+    LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+
+    // Through const_iterators the elements are only read.
+    std::vector<int> read;
+    bizwen::for_each(c.cbegin() + f, c.cbegin() + l, [&](const int& x) { read.push_back(x); });
+    assert(std::equal(read.begin(), read.end(), v.begin() + f, v.begin() + l));
+  });
+}
+
+template <class C>
+void test() {
+  for_each_deque_shape(testN<C>);
+}
+
+int main(int, char**) {
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<block_int<16> > >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<int, min_allocator<int> > >();
+#endif
+
+  return 0;
+}
@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// UNSUPPORTED: c++03, c++11, c++14, c++17
+
+// "deque_algorithms.hpp"
+
+// template <class ForwardIterator, class T>
+//   ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last, const T& value);
+// template <class ForwardIterator, class T, class Compare>
+//   ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last, const T& value, Compare comp);
+
+//  Searches in two steps: over the first element of each block the range
+//  touches, read through the map, and then with raw pointers in the one
+//  block that can hold the answer. Makes O(log N) comparisons.
+
+#include "deque_algorithms.hpp"
+#include "deque.hpp"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <vector>
+
+#include "test_macros.h"
+#include "counting_predicates.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+#include "test_iterators.h"
+
+template <class C>
+void testN(int start, int N) {
+  typedef typename C::value_type T;
+  typedef typename C::const_iterator CI;
+  typedef random_access_iterator<const int*> RI;
+  const int b = deque_block_elements<C>();
+  const C c   = make_deque<C>(N, start, [](int i) { return i / 3; });
+  const std::vector<int> v(c.begin(), c.end());
+  const int bound = 2 * std::bit_width(static_cast<unsigned>(N)) + 2;
+
+  int offsets[] = {0, 1, b - 1, b, b + 1, N / 2, N - 1, N};
+  int keys[]    = {-1, 0, (b - 1) / 3, b / 3, (b + 1) / 3, N / 6, (N - 1) / 3, N / 3 + 1};
+  for (int f : offsets) {
+    for (int l : offsets) {
+      if (f < 0 || l > N || f > l)
+        continue;
+      for (int k : keys) {
+        const RI r = std::lower_bound(RI(v.data() + f), RI(v.data() + l), k);
+        const CI i = bizwen::lower_bound(c.begin() + f, c.begin() + l, T(k));
+        assert(i - c.begin() == base(r) - v.data());
+
+        int count = 0;
+        auto less = [](const T& e, int key) { return e < key; };
+        const CI j = bizwen::lower_bound(c.begin() + f, c.begin() + l, k, counting_predicate(less, count));
+        assert(j == i);
+        assert(count <= bound);
+      }
+    }
+  }
+}
+
+template <class C>
+void test() {
+  for_each_deque_shape(testN<C>);
+}
+
+int main(int, char**) {
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<block_int<1> > >();
+  test<bizwen::deque<block_int<16> > >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<int, min_allocator<int> > >();
+#endif
+
+  return 0;
+}
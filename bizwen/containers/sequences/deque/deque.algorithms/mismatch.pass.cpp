@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque_algorithms.hpp"
+
+// template <class InputIterator1, class InputIterator2>
+//   pair<InputIterator1, InputIterator2>
+//   mismatch(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2);
+// template <class InputIterator1, class InputIterator2, class BinaryPredicate>
+//   pair<InputIterator1, InputIterator2>
+//   mismatch(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, BinaryPredicate pred);
+// template <class InputIterator1, class InputIterator2>
+//   pair<InputIterator1, InputIterator2>
+//   mismatch(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2);
+// template <class InputIterator1, class InputIterator2, class BinaryPredicate>
+//   pair<InputIterator1, InputIterator2>
+//   mismatch(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+//            BinaryPredicate pred);
+
+//  Overloads for when either range is a deque. Two deques are walked one pair
+//  of contiguous chunks at a time, whatever the offsets of their first elements
+//  in their blocks.
+
+#include "deque_algorithms.hpp"
+#include "deque.hpp"
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <vector>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+#include "test_iterators.h"
+
+// c and v hold the same elements but for the one at p, if any.
+template <class C>
+void check(const C& c, const std::vector<int>& v, int p) {
+  typedef typename C::const_iterator CI;
+  typedef random_access_iterator<const int*> RI;
+  typedef cpp17_input_iterator<const int*> II;
+  const int N    = static_cast<int>(c.size());
+  const int want = p < N ? p : N;
+
+  std::pair<CI, RI> r = bizwen::mismatch(c.begin(), c.end(), RI(v.data()));
+  assert(r.first - c.begin() == want);
+  assert(base(r.second) - v.data() == want);
+  r = bizwen::mismatch(c.begin(), c.end(), RI(v.data()), std::equal_to<>());
+  assert(r.first - c.begin() == want);
+
+  std::pair<CI, II> s = bizwen::mismatch(c.begin(), c.end(), II(v.data()), II(v.data() + N));
+  assert(s.first - c.begin() == want);
+  assert(base(s.second) - v.data() == want);
+
+  // The shorter range ends the search.
+  const int half = N / 2;
+  r = bizwen::mismatch(c.begin(), c.end(), RI(v.data()), RI(v.data() + half));
+  assert(r.first - c.begin() == (want < half ? want : half));
+  r = bizwen::mismatch(c.begin(), c.begin() + half, RI(v.data()), RI(v.data() + N), std::equal_to<>());
+  assert(r.first - c.begin() == (want < half ? want : half));
+
+  // The deque as the second range.
+  std::pair<RI, CI> t = bizwen::mismatch(RI(v.data()), RI(v.data() + N), c.begin());
+  assert(base(t.first) - v.data() == want);
+  assert(t.second - c.begin() == want);
+  t = bizwen::mismatch(RI(v.data()), RI(v.data() + N), c.begin(), c.end(), std::equal_to<>());
+  assert(t.second - c.begin() == want);
+
+  // A predicate that holds everywhere finds no mismatch.
+  r = bizwen::mismatch(c.begin(), c.end(), RI(v.data()), [](int, int) { return true; });
+  assert(r.first == c.end());
+}
+
+template <class C>
+void testN(int start, int N) {
+  const int b = deque_block_elements<C>();
+  const C c   = make_deque<C>(N, start, [](int i) { return i % 13; });
+  const std::vector<int> v(c.begin(), c.end());
+  check(c, v, N);
+
+  int positions[] = {0, b - 1, b, N / 2, N - 1};
+  for (int p : positions) {
+    if (p < 0 || p >= N)
+      continue;
+    std::vector<int> w = v;
+    w[p]               = -1;
+    check(c, w, p);
+
+    // Two deques, whose chunks end at different places.
+    int starts[] = {0, 1, b / 2};
+    for (int s : starts) {
+      C d  = make_deque<C>(N, s, [](int i) { return i % 13; });
+      d[p] = -1;
+      std::pair<typename C::const_iterator, typename C::iterator> r = bizwen::mismatch(c.begin(), c.end(), d.begin());
+      assert(r.first - c.begin() == p);
+      assert(r.second - d.begin() == p);
+      r = bizwen::mismatch(c.begin(), c.end(), d.begin(), d.end());
+      assert(r.first - c.begin() == p);
+      r = bizwen::mismatch(c.begin(), c.end(), d.begin(), d.begin() + p, std::equal_to<>());
+      assert(r.first - c.begin() == p);
+      assert(r.second == d.begin() + p);
+    }
+  }
+}
+
+template <class C>
+void test() {
+  for_each_deque_shape(testN<C>);
+}
+
+int main(int, char**) {
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<block_int<16> > >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<int, min_allocator<int> > >();
+#endif
+
+  return 0;
+}
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque_algorithms.hpp"
+
+// template <class InputIterator>
+//   typename iterator_traits<InputIterator>::value_type
+//   reduce(InputIterator first, InputIterator last);
+// template <class InputIterator, class T>
+//   T reduce(InputIterator first, InputIterator last, T init);
+// template <class InputIterator, class T, class BinaryOperation>
+//   T reduce(InputIterator first, InputIterator last, T init, BinaryOperation op);
+
+//  Overloads for deque iterators that fold one contiguous segment at a time.
+//  They may regroup and reorder the elements, so op must be associative and
+//  commutative.
+
+#include "deque_algorithms.hpp"
+#include "deque.hpp"
+#include <cassert>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+#include "test_iterators.h"
+
+struct Max {
+  long long operator()(long long x, long long y) const { return x < y ? y : x; }
+};
+
+template <class C>
+void testN(int start, int N) {
+  typedef random_access_iterator<const int*> RI;
+  const C c = make_deque<C>(N, start, [](int i) { return i % 13; });
+  const std::vector<int> v(c.begin(), c.end());
+  for_each_subrange(N, [&](int f, int l) {
+    const RI rf(v.data() + f);
+    const RI rl(v.data() + l);
+    typename C::const_iterator first = c.begin() + f;
+    typename C::const_iterator last  = c.begin() + l;
+
+    const long long sum = std::accumulate(rf, rl, 0LL);
+    assert(static_cast<long long>(bizwen::reduce(first, last)) == sum);
+    assert(bizwen::reduce(first, last, 7LL) == sum + 7);
+    assert(bizwen::reduce(first, last, -1LL, Max()) == std::accumulate(rf, rl, -1LL, Max()));
+    assert(bizwen::reduce(first, last, 0LL, std::plus<>()) == sum);
+  });
+}
+
+template <class C>
+void test() {
+  for_each_deque_shape(testN<C>);
+}
+
+int main(int, char**) {
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<block_int<16> > >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<int, min_allocator<int> > >();
+#endif
+
+  return 0;
+}
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque_algorithms.hpp"
+
+// template <class RandomAccessIterator>
+//   void sort(RandomAccessIterator first, RandomAccessIterator last);
+// template <class RandomAccessIterator, class Compare>
+//   void sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp);
+// template <class T, class Allocator>
+//   void sort(deque<T, Allocator>& c);
+// template <class T, class Allocator, class Compare>
+//   void sort(deque<T, Allocator>& c, Compare comp);
+
+//  Sorts each block of the range with raw pointers and then merges across
+//  blocks. It never allocates.
+
+#include "deque_algorithms.hpp"
+#include "deque.hpp"
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <vector>
+
+#include "test_macros.h"
+#include "count_new.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+
+// A deque holding 0, ..., 100 in an order that repeats every 101 elements.
+template <class C>
+C make_shuffled(int size, int start = 0) {
+  return make_deque<C>(size, start, [](int i) { return i * 7919 % 101; });
+}
+
+template <class C>
+void testN(int start, int N) {
+  for_each_subrange(N, [&](int f, int l) {
+    C c = make_shuffled<C>(N, start);
+    std::vector<int> v(c.begin(), c.end());
+    std::sort(v.begin() + f, v.begin() + l);
+    bizwen::sort(c.begin() + f, c.begin() + l);
+    assert(std::equal(c.begin(), c.end(), v.begin(), v.end()));
+
+    std::sort(v.begin() + f, v.begin() + l, std::greater<>());
+    bizwen::sort(c.begin() + f, c.begin() + l, std::greater<>());
+    assert(std::equal(c.begin(), c.end(), v.begin(), v.end()));
+  });
+
+  C c = make_shuffled<C>(N, start);
+  std::vector<int> v(c.begin(), c.end());
+  std::sort(v.begin(), v.end());
+  bizwen::sort(c);
+  assert(std::equal(c.begin(), c.end(), v.begin(), v.end()));
+  bizwen::sort(c, [](int x, int y) { return x % 10 < y % 10 || (x % 10 == y % 10 && x < y); });
+  assert(std::is_sorted(c.begin(), c.end(), [](int x, int y) { return x % 10 < y % 10; }));
+}
+
+template <class C>
+void test() {
+  for_each_deque_shape(testN<C>);
+}
+
+int main(int, char**) {
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<block_int<1> > >();
+  test<bizwen::deque<block_int<16> > >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<int, min_allocator<int> > >();
+#endif
+
+  {
+    bizwen::deque<block_int<16> > c = make_shuffled<bizwen::deque<block_int<16> > >(5000, 7);
+    globalMemCounter.reset();
+    bizwen::sort(c);
+    assert(globalMemCounter.checkNewCalledEq(0));
+    assert(std::is_sorted(c.begin(), c.end()));
+  }
+
+  return 0;
+}
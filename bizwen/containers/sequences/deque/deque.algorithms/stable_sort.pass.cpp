@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque_algorithms.hpp"
+
+// template <class RandomAccessIterator>
+//   void stable_sort(RandomAccessIterator first, RandomAccessIterator last);
+// template <class RandomAccessIterator, class Compare>
+//   void stable_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp);
+// template <class T, class Allocator>
+//   void stable_sort(deque<T, Allocator>& c);
+// template <class T, class Allocator, class Compare>
+//   void stable_sort(deque<T, Allocator>& c, Compare comp);
+
+//  Sorts each block of the range with raw pointers and then merges across
+//  blocks through a buffer of one block. The buffer is a spare block of the
+//  deque when it has one, and goes back to the spare blocks afterwards, so at
+//  most one block is allocated and it is freed before returning.
+
+#include "deque_algorithms.hpp"
+#include "deque.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "test_macros.h"
+#include "count_new.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+
+// Ordered by key only, so that the order of equal elements shows in seq.
+struct Keyed {
+  int key;
+  int seq;
+
+  Keyed(int i = 0) : key(i * 7919 % 37), seq(i) {}
+
+  friend bool operator<(const Keyed& x, const Keyed& y) { return x.key < y.key; }
+  friend bool operator==(const Keyed& x, const Keyed& y) { return x.key == y.key && x.seq == y.seq; }
+};
+
+// A Keyed whose deques keep no spare blocks.
+struct Unspared : Keyed {
+  Unspared(int i = 0) : Keyed(i) {}
+};
+
+// Keyed keeps the two spare blocks that test_merge_buffer leaves at the back
+// of its deque; Unspared keeps none.
+namespace bizwen {
+template <>
+struct deque_block_traits<Keyed> {
+  static constexpr std::size_t block_elements   = 16;
+  static constexpr std::size_t max_spare_blocks = 2;
+};
+
+template <>
+struct deque_block_traits<Unspared> {
+  static constexpr std::size_t block_elements   = 16;
+  static constexpr std::size_t max_spare_blocks = 0;
+};
+} // namespace bizwen
+
+template <class C>
+void testN(int start, int N) {
+  typedef typename C::value_type T;
+  for_each_subrange(N, [&](int f, int l) {
+    C c = make_deque<C>(N, start);
+    std::vector<T> v(c.begin(), c.end());
+    std::stable_sort(v.begin() + f, v.begin() + l);
+    bizwen::stable_sort(c.begin() + f, c.begin() + l);
+    assert(std::equal(c.begin(), c.end(), v.begin(), v.end()));
+
+    auto by_key_down = [](const T& x, const T& y) { return y.key < x.key; };
+    std::stable_sort(v.begin() + f, v.begin() + l, by_key_down);
+    bizwen::stable_sort(c.begin() + f, c.begin() + l, by_key_down);
+    assert(std::equal(c.begin(), c.end(), v.begin(), v.end()));
+  });
+
+  C c = make_deque<C>(N, start);
+  std::vector<T> v(c.begin(), c.end());
+  std::stable_sort(v.begin(), v.end());
+  bizwen::stable_sort(c);
+  assert(std::equal(c.begin(), c.end(), v.begin(), v.end()));
+}
+
+template <class C>
+void test() {
+  for_each_deque_shape(testN<C>);
+}
+
+// The merge buffer is a spare block of the deque when it has one, and it is
+// handed back afterwards: sorting neither allocates nor frees, whatever the
+// size, and the next blocks the deque needs are still the spare ones. Without
+// a spare block one block is allocated and freed again.
+void test_merge_buffer() {
+  const int ns[] = {17, 5000, 100 * 16 + 3};
+  for (int N : ns) {
+    {
+      typedef bizwen::deque<Keyed> C;
+      const int b = deque_block_elements<C>();
+      C c         = make_deque<C>(N, 7);
+      for (int i = 0; i < 2 * b; ++i)
+        c.push_back(i);
+      for (int i = 0; i < 2 * b; ++i)
+        c.pop_back();
+      globalMemCounter.reset();
+      bizwen::stable_sort(c);
+      bizwen::stable_sort(c.begin() + 1, c.end() - 1, [](const Keyed& x, const Keyed& y) { return y.key < x.key; });
+      assert(globalMemCounter.checkNewCalledEq(0));
+      assert(globalMemCounter.checkDeleteCalledEq(0));
+      for (int i = 0; i < 2 * b; ++i)
+        c.push_back(i);
+      assert(globalMemCounter.checkNewCalledEq(0));
+    }
+    {
+      typedef bizwen::deque<Unspared> C;
+      C c = make_deque<C>(N, 7);
+      globalMemCounter.reset();
+      bizwen::stable_sort(c);
+      assert(!globalMemCounter.checkNewCalledGreaterThan(1));
+      assert(globalMemCounter.checkDeleteCalledEq(globalMemCounter.new_called));
+      assert(std::is_sorted(c.begin(), c.end()));
+    }
+  }
+}
+
+int main(int, char**) {
+  test<bizwen::deque<Keyed> >();
+  test<bizwen::deque<Unspared> >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<Keyed, min_allocator<Keyed> > >();
+#endif
+  test_merge_buffer();
+
+  return 0;
+}
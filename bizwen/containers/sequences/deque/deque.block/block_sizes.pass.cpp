@@ -0,0 +1,160 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// UNSUPPORTED: c++03, c++11, c++14, c++17
+
+// "deque.hpp"
+
+// template <class T>
+// struct deque_block_traits {
+//   static constexpr size_type block_elements;
+// };
+
+//  The element access, capacity and modifier operations behave the same with
+//  blocks of any size. Each operation is checked against std::deque for
+//  blocks of the default size, of 16 and of 64 elements, with the first
+//  element at several offsets into its block.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+
+template <class C>
+void check(const C& c, const std::deque<int>& model) {
+  assert(c.size() == model.size());
+  assert(std::equal(c.begin(), c.end(), model.begin(), model.end()));
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+template <class C>
+void test_access(int start, int N) {
+  const C c = make_deque<C>(N, start);
+  for (int i = 0; i < N; ++i) {
+    assert(c[i] == i);
+    assert(c.at(i) == i);
+  }
+  if (N > 0) {
+    assert(c.front() == 0);
+    assert(c.back() == N - 1);
+  }
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+template <class C>
+void test_push_pop(int start, int N) {
+  const int b = deque_block_elements<C>();
+  C c         = make_deque<C>(N, start);
+  std::deque<int> model(c.begin(), c.end());
+  for (int i = 0; i < b + 1; ++i) {
+    c.push_back(-i);
+    model.push_back(-i);
+    c.push_front(i + N);
+    model.push_front(i + N);
+  }
+  check(c, model);
+  for (int i = 0; i < 2 * b + 1 && !model.empty(); ++i) {
+    c.pop_front();
+    model.pop_front();
+    if (model.empty())
+      break;
+    c.pop_back();
+    model.pop_back();
+  }
+  check(c, model);
+}
+
+template <class C>
+void test_resize(int start, int N) {
+  const int b = deque_block_elements<C>();
+  C c         = make_deque<C>(N, start);
+  std::deque<int> model(c.begin(), c.end());
+  c.resize(N + b + 1);
+  model.resize(N + b + 1);
+  check(c, model);
+  c.resize(N / 2, 7);
+  model.resize(N / 2, 7);
+  check(c, model);
+  c.shrink_to_fit();
+  check(c, model);
+}
+
+template <class C>
+void test_assign(int start, int N) {
+  const std::vector<int> v = {5, 4, 3, 2, 1};
+  C c                      = make_deque<C>(N, start);
+  c.assign(N / 2 + 1, 9);
+  check(c, std::deque<int>(N / 2 + 1, 9));
+  c.assign(v.begin(), v.end());
+  check(c, std::deque<int>(v.begin(), v.end()));
+}
+
+template <class C>
+void test_insert_erase(int start, int N) {
+  typedef typename C::value_type T;
+  const C c0 = make_deque<C>(N, start);
+  const std::deque<int> model0(c0.begin(), c0.end());
+  const std::vector<int> v(N + 1, -3);
+  for_each_subrange(N, [&](int f, int l) {
+    C c                   = c0;
+    std::deque<int> model = model0;
+    c.erase(c.begin() + f, c.begin() + l);
+    model.erase(model.begin() + f, model.begin() + l);
+    check(c, model);
+
+    c.insert(c.begin() + f, l - f, T(-1));
+    model.insert(model.begin() + f, l - f, -1);
+    check(c, model);
+
+    c.insert(c.begin() + f, v.begin(), v.begin() + (l - f));
+    model.insert(model.begin() + f, v.begin(), v.begin() + (l - f));
+    check(c, model);
+
+    c.emplace(c.begin() + l, -4);
+    model.emplace(model.begin() + l, -4);
+    T x(-5);
+    c.insert(c.begin() + f, std::move(x));
+    model.insert(model.begin() + f, -5);
+    check(c, model);
+
+    c.erase(c.begin() + f);
+    model.erase(model.begin() + f);
+    check(c, model);
+  });
+}
+
+template <class C>
+void test_swap(int start, int N) {
+  C c1 = make_deque<C>(N, start);
+  C c2 = make_deque<C>(N / 2 + 3, N % 7, [](int i) { return -i; });
+  const std::deque<int> m1(c1.begin(), c1.end());
+  const std::deque<int> m2(c2.begin(), c2.end());
+  swap(c1, c2);
+  check(c1, m2);
+  check(c2, m1);
+}
+
+int main(int, char**) {
+  for_each_block_size([]<class C>() {
+    for_each_deque_shape([](int start, int N) {
+      test_access<C>(start, N);
+      test_push_pop<C>(start, N);
+      test_resize<C>(start, N);
+      test_assign<C>(start, N);
+      test_insert_erase<C>(start, N);
+      test_swap<C>(start, N);
+    });
+  });
+
+  return 0;
+}
@@ -0,0 +1,202 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// template <class T>
+// struct deque_block_traits {
+//   static constexpr size_type block_elements;
+// };
+
+//  block_elements is a power of two, so that finding the block and the slot of
+//  an element takes a shift and a mask. By default it is the largest power of
+//  two whose block fits in 4096 bytes, or 1 for larger elements; a deque of a
+//  type whose traits give anything else does not compile.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+
+struct Message {
+  int value;
+  char payload[12];
+
+  Message(int v = 0) : value(v), payload() {}
+
+  operator int() const { return value; }
+};
+
+// 12 bytes: 4096 / 12 is not a power of two.
+struct Triple {
+  int value;
+  int other[2];
+
+  Triple(int v = 0) : value(v), other() {}
+
+  operator int() const { return value; }
+};
+
+// Larger than a default block, with no traits of its own.
+struct Page {
+  int value;
+  char payload[5000];
+
+  Page(int v = 0) : value(v), payload() {}
+
+  operator int() const { return value; }
+};
+
+struct Huge {
+  int value;
+  char payload[16380];
+
+  Huge(int v = 0) : value(v), payload() {}
+
+  operator int() const { return value; }
+};
+
+namespace bizwen {
+template <>
+struct deque_block_traits<Message> {
+  static constexpr std::size_t block_elements = 65536 / sizeof(Message);
+};
+
+template <>
+struct deque_block_traits<Huge> {
+  static constexpr std::size_t block_elements = 8;
+};
+} // namespace bizwen
+
+static_assert(sizeof(Message) == 16, "");
+static_assert(bizwen::deque_block_traits<int>::block_elements == 4096 / sizeof(int), "");
+static_assert(bizwen::deque_block_traits<char>::block_elements == 4096, "");
+static_assert(bizwen::deque_block_traits<Message>::block_elements == 4096, "");
+static_assert(bizwen::deque_block_traits<Huge>::block_elements == 8, "");
+static_assert(bizwen::deque_block_traits<block_int<16> >::block_elements == 16, "");
+static_assert(sizeof(Triple) == 12, "");
+static_assert(bizwen::deque_block_traits<Triple>::block_elements == 256, "");
+static_assert(bizwen::deque_block_traits<Page>::block_elements == 1, "");
+static_assert(bizwen::deque_block_traits<double[3]>::block_elements == 128, "");
+
+static_assert(std::has_single_bit(bizwen::deque_block_traits<char>::block_elements), "");
+static_assert(std::has_single_bit(bizwen::deque_block_traits<int>::block_elements), "");
+static_assert(std::has_single_bit(bizwen::deque_block_traits<Message>::block_elements), "");
+static_assert(std::has_single_bit(bizwen::deque_block_traits<Triple>::block_elements), "");
+static_assert(std::has_single_bit(bizwen::deque_block_traits<Page>::block_elements), "");
+static_assert(std::has_single_bit(bizwen::deque_block_traits<Huge>::block_elements), "");
+
+// Records the largest request made for the element type itself, which is the
+// size of one block.
+template <class T>
+struct block_recording_allocator {
+  typedef T value_type;
+
+  static std::size_t largest;
+
+  block_recording_allocator() = default;
+  template <class U>
+  block_recording_allocator(const block_recording_allocator<U>&) {}
+
+  T* allocate(std::size_t n) {
+    if (n > largest)
+      largest = n;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* p, std::size_t n) { std::allocator<T>().deallocate(p, n); }
+
+  template <class U>
+  friend bool operator==(const block_recording_allocator&, const block_recording_allocator<U>&) {
+    return true;
+  }
+};
+
+template <class T>
+std::size_t block_recording_allocator<T>::largest = 0;
+
+// The elements of one block are contiguous, so a deque spanning two blocks
+// contains a contiguous run of at least one full block.
+template <class C>
+std::size_t longest_contiguous_run(const C& c) {
+  std::size_t longest = 0;
+  std::size_t run     = 0;
+  for (std::size_t i = 0; i < c.size(); ++i) {
+    if (i != 0 && &c[i - 1] + 1 == &c[i])
+      ++run;
+    else
+      run = 1;
+    if (run > longest)
+      longest = run;
+  }
+  return longest;
+}
+
+template <class C>
+void test(int start) {
+  const int b = deque_block_elements<C>();
+  C c;
+  for (int i = 0; i < start; ++i)
+    c.push_front(i);
+  for (int i = 0; i < 2 * b; ++i)
+    c.push_back(i);
+  assert(longest_contiguous_run(c) >= static_cast<std::size_t>(b));
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+  while (static_cast<int>(c.size()) > 1)
+    c.pop_front();
+  assert(c.front() == 2 * b - 1);
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+template <class C>
+void test() {
+  int rng[]   = {0, 1, 2, 15, 16, 17, 63, 64, 65};
+  const int N = sizeof(rng) / sizeof(rng[0]);
+  for (int i = 0; i < N; ++i)
+    test<C>(rng[i]);
+}
+
+template <class T>
+void test_block_allocation() {
+  typedef block_recording_allocator<T> A;
+  A::largest = 0;
+  {
+    bizwen::deque<T, A> c;
+    for (int i = 0; i < 3 * deque_block_elements<bizwen::deque<T, A> >(); ++i)
+      c.push_back(i);
+  }
+  assert(A::largest == bizwen::deque_block_traits<T>::block_elements);
+}
+
+int main(int, char**) {
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<block_int<1> > >();
+  test<bizwen::deque<block_int<16> > >();
+  test<bizwen::deque<block_int<64> > >();
+  test<bizwen::deque<Message> >();
+  test<bizwen::deque<Huge> >();
+  test<bizwen::deque<Triple> >();
+  test<bizwen::deque<Page> >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<block_int<16>, min_allocator<block_int<16> > > >();
+  test<bizwen::deque<Message, min_allocator<Message> > >();
+#endif
+  test_block_allocation<int>();
+  test_block_allocation<block_int<16> >();
+  test_block_allocation<Message>();
+  test_block_allocation<Huge>();
+  test_block_allocation<Triple>();
+  test_block_allocation<Page>();
+
+  return 0;
+}
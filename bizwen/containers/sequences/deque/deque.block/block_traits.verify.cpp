@@ -0,0 +1,38 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// template <class T>
+// struct deque_block_traits {
+//   static constexpr size_type block_elements;
+// };
+
+//  block_elements must be a power of two.
+
+#include "deque.hpp"
+#include <cstddef>
+
+#include "test_macros.h"
+
+struct Odd {
+  int value;
+};
+
+namespace bizwen {
+template <>
+struct deque_block_traits<Odd> {
+  static constexpr std::size_t block_elements = 100;
+};
+} // namespace bizwen
+
+void f() {
+  bizwen::deque<Odd> c;
+  // expected-error-re@*:* {{static assertion failed{{.*}}}}
+  (void)c;
+}
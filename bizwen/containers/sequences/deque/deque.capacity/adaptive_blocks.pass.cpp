@@ -0,0 +1,283 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// template <class T>
+// struct deque_block_traits {
+//   static constexpr size_t block_elements;
+//   static constexpr size_t min_block_elements; // optional
+// };
+// span<const value_type> block_extent(const_iterator pos) const noexcept;
+
+//  When deque_block_traits<T>::min_block_elements is smaller than
+//  block_elements, the first block a deque allocates holds min_block_elements
+//  and each block further from it, at either end, holds twice as many as its
+//  neighbour, up to block_elements. Both are powers of two. Once the deque is
+//  empty and its blocks are released the next block is small again. Without
+//  min_block_elements every block holds block_elements. block_extent() gives
+//  all the slots of the block holding pos, whatever its size.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+
+struct allocation_log {
+  static std::vector<std::size_t> blocks;
+  static std::size_t live;
+
+  static void reset() { blocks.clear(); }
+};
+
+std::vector<std::size_t> allocation_log::blocks;
+std::size_t allocation_log::live = 0;
+
+// Records the size of every block, which are the requests for Elem, and keeps
+// the number of element slots currently allocated in live.
+template <class T, class Elem>
+struct block_log_allocator {
+  typedef T value_type;
+
+  block_log_allocator() = default;
+  template <class U>
+  block_log_allocator(const block_log_allocator<U, Elem>&) {}
+
+  T* allocate(std::size_t n) {
+    if (std::is_same<T, Elem>::value) {
+      allocation_log::blocks.push_back(n);
+      allocation_log::live += n;
+    }
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* p, std::size_t n) {
+    if (std::is_same<T, Elem>::value)
+      allocation_log::live -= n;
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  template <class U>
+  friend bool operator==(const block_log_allocator&, const block_log_allocator<U, Elem>&) {
+    return true;
+  }
+};
+
+// An int whose deques start with blocks of Min elements and grow them up to
+// Max. Spare blocks are not kept, so that every block allocated is in use.
+template <std::size_t Min, std::size_t Max>
+struct adaptive_int {
+  int value;
+
+  adaptive_int(int v = 0) : value(v) {}
+
+  operator int() const { return value; }
+};
+
+namespace bizwen {
+template <std::size_t Min, std::size_t Max>
+struct deque_block_traits<adaptive_int<Min, Max> > {
+  static constexpr std::size_t block_elements     = Max;
+  static constexpr std::size_t min_block_elements = Min;
+  static constexpr std::size_t max_spare_blocks   = 0;
+};
+} // namespace bizwen
+
+template <class T>
+std::size_t min_block_elements() {
+  if constexpr (requires { bizwen::deque_block_traits<T>::min_block_elements; })
+    return bizwen::deque_block_traits<T>::min_block_elements;
+  else
+    return bizwen::deque_block_traits<T>::block_elements;
+}
+
+// The number of elements of the k-th block away from the first one.
+template <class C>
+std::size_t expected_block(std::size_t k) {
+  const std::size_t b = static_cast<std::size_t>(deque_block_elements<C>());
+  std::size_t n       = min_block_elements<typename C::value_type>();
+  for (; k != 0 && n < b; --k)
+    n *= 2;
+  return n;
+}
+
+// Compares c with model through every way of reaching an element, and checks
+// that the blocks in use are exactly the ones allocated.
+template <class C>
+void check(const C& c, const std::vector<int>& model) {
+  typedef typename C::const_iterator I;
+  const int N = static_cast<int>(model.size());
+  assert(static_cast<int>(c.size()) == N);
+  assert(c.end() - c.begin() == N);
+  for (int i = 0; i < N; ++i) {
+    assert(c[i] == model[i]);
+    assert(c.at(i) == model[i]);
+    I it = c.begin() + i;
+    assert(*it == model[i]);
+    assert(it - c.begin() == i);
+    assert(c.end() - it == N - i);
+    assert(it == c.end() - (N - i));
+  }
+  int i = 0;
+  for (I it = c.begin(); it != c.end(); ++it, ++i)
+    assert(*it == model[i]);
+  for (I it = c.end(); it != c.begin(); --i)
+    assert(*--it == model[i - 1]);
+
+  // Each segment lies inside the block that block_extent() reports for it.
+  std::size_t total = 0;
+  I it              = c.begin();
+  for (auto seg : c.segments()) {
+    const auto block = c.block_extent(it);
+    assert(std::has_single_bit(block.size()));
+    assert(block.size() >= min_block_elements<typename C::value_type>());
+    assert(block.size() <= static_cast<std::size_t>(deque_block_elements<C>()));
+    assert(seg.data() >= block.data());
+    assert(seg.data() + seg.size() <= block.data() + block.size());
+    total += seg.size();
+    it += static_cast<typename C::difference_type>(seg.size());
+  }
+  assert(total == c.size());
+  assert(c.capacity_front() + c.size() + c.capacity_back() == allocation_log::live);
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+// Growing at one end allocates min_block_elements first and then blocks twice
+// as large as the previous one, up to block_elements.
+template <class C>
+void test_growth(int N, bool front) {
+  std::vector<int> model;
+  allocation_log::reset();
+  {
+    C c;
+    for (int i = 0; i < N; ++i) {
+      if (front) {
+        c.push_front(i);
+        model.insert(model.begin(), i);
+      } else {
+        c.push_back(i);
+        model.push_back(i);
+      }
+    }
+    check(c, model);
+    for (std::size_t k = 0; k < allocation_log::blocks.size(); ++k)
+      assert(allocation_log::blocks[k] == expected_block<C>(k));
+
+    // The segments of a deque grown at the back are its blocks, in order.
+    if (!front) {
+      std::size_t k    = 0;
+      std::size_t seen = 0;
+      typename C::const_iterator it = c.begin();
+      for (auto seg : c.segments()) {
+        assert(c.block_extent(it).size() == expected_block<C>(k));
+        seen += seg.size();
+        if (seen < c.size())
+          assert(seg.size() == expected_block<C>(k));
+        it += static_cast<typename C::difference_type>(seg.size());
+        ++k;
+      }
+    }
+
+    // Emptied and released, the deque starts again from a small block.
+    c.release();
+    assert(allocation_log::live == 0);
+    allocation_log::reset();
+    c.push_back(1);
+    assert(allocation_log::blocks.size() == 1);
+    assert(allocation_log::blocks[0] == expected_block<C>(0));
+  }
+  assert(allocation_log::live == 0);
+}
+
+// Grows at both ends, shrinks from both ends and grows again, so that the
+// deque holds blocks of every size on both sides of the first one.
+template <class C>
+void test_mixed(int N) {
+  typedef typename C::value_type T;
+  std::vector<int> model;
+  C c;
+  for (int i = 0; i < N; ++i) {
+    if (i % 3 == 0) {
+      c.push_front(-i);
+      model.insert(model.begin(), -i);
+    } else {
+      c.push_back(i);
+      model.push_back(i);
+    }
+  }
+  check(c, model);
+  for (int i = 0; i < N / 2; ++i) {
+    if (i % 2 == 0) {
+      c.pop_front();
+      model.erase(model.begin());
+    } else {
+      c.pop_back();
+      model.pop_back();
+    }
+  }
+  check(c, model);
+  for (int i = 0; i < N; ++i) {
+    c.push_front(i);
+    model.insert(model.begin(), i);
+  }
+  check(c, model);
+
+  c.insert(c.begin() + static_cast<int>(c.size()) / 3, N, T(7));
+  model.insert(model.begin() + static_cast<int>(model.size()) / 3, N, 7);
+  check(c, model);
+  if (c.size() > 2) {
+    c.erase(c.begin() + 1, c.begin() + static_cast<int>(c.size()) / 2);
+    model.erase(model.begin() + 1, model.begin() + static_cast<int>(model.size()) / 2);
+    check(c, model);
+  }
+
+  c.reserve_front(static_cast<std::size_t>(N));
+  c.reserve_back(static_cast<std::size_t>(N));
+  check(c, model);
+  c.shrink_to_fit();
+  check(c, model);
+}
+
+template <class C>
+void test() {
+  int rng[]   = {0, 1, 2, 3, 15, 16, 17, 63, 64, 65, 1023, 1024, 1025, 2049};
+  const int N = sizeof(rng) / sizeof(rng[0]);
+  for (int i = 0; i < N; ++i) {
+    test_growth<C>(rng[i], false);
+    test_growth<C>(rng[i], true);
+    test_mixed<C>(rng[i]);
+  }
+  assert(allocation_log::live == 0);
+}
+
+template <class T>
+using logged_deque = bizwen::deque<T, block_log_allocator<T, T> >;
+
+int main(int, char**) {
+  test<logged_deque<adaptive_int<1, 16> > >();
+  test<logged_deque<adaptive_int<4, 64> > >();
+  test<logged_deque<adaptive_int<8, 1024> > >();
+  test<logged_deque<adaptive_int<16, 16> > >();
+
+  // Without min_block_elements every block is a full one.
+  allocation_log::reset();
+  {
+    logged_deque<block_int<16> > c;
+    for (int i = 0; i < 100; ++i)
+      c.push_back(i);
+    for (std::size_t k = 0; k < allocation_log::blocks.size(); ++k)
+      assert(allocation_log::blocks[k] == 16);
+  }
+
+  return 0;
+}
@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// size_type capacity_front() const noexcept;
+// size_type capacity_back() const noexcept;
+// size_type block_count() const noexcept;
+// size_type map_capacity() const noexcept;
+
+//  capacity_front() and capacity_back() count the free slots before the first
+//  and after the last element in the blocks the deque holds, block_count()
+//  those blocks, and map_capacity() the blocks the map can point to without
+//  being reallocated. Spare blocks kept for reuse are not counted.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+
+template <class C>
+void check(const C& c) {
+  typedef typename C::size_type S;
+  const S b = static_cast<S>(deque_block_elements<C>());
+  ASSERT_NOEXCEPT(c.capacity_front());
+  ASSERT_NOEXCEPT(c.capacity_back());
+  ASSERT_NOEXCEPT(c.block_count());
+  ASSERT_NOEXCEPT(c.map_capacity());
+  assert(c.block_count() * b == c.capacity_front() + c.size() + c.capacity_back());
+  assert(c.map_capacity() >= c.block_count());
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+// Nothing beyond the partly used blocks at either end is held after
+// shrink_to_fit.
+template <class C>
+void check_shrunk(const C& c) {
+  typedef typename C::size_type S;
+  const S b = static_cast<S>(deque_block_elements<C>());
+  check(c);
+  if (c.empty()) {
+    assert(c.block_count() == 0);
+  } else {
+    assert(c.capacity_front() < b);
+    assert(c.capacity_back() < b);
+  }
+}
+
+template <class C>
+void testN(int start, int N) {
+  typedef typename C::size_type S;
+  const int b = deque_block_elements<C>();
+  C c         = make_deque<C>(N, start);
+  check(c);
+  assert(c.capacity_front() < static_cast<S>(b));
+
+  c.reserve_back(3 * b);
+  check(c);
+  assert(c.capacity_back() >= static_cast<S>(3 * b));
+  c.reserve_front(2 * b + 1);
+  check(c);
+  assert(c.capacity_front() >= static_cast<S>(2 * b + 1));
+  assert(c.block_count() * b >= c.size() + 5 * b + 1);
+
+  for (int i = 0; i < b + 1; ++i) {
+    c.push_back(i);
+    c.push_front(i);
+  }
+  check(c);
+  c.pop_back();
+  c.pop_front();
+  check(c);
+
+  c.shrink_to_fit();
+  check_shrunk(c);
+
+  while (!c.empty()) {
+    c.pop_front();
+    check(c);
+  }
+  c.shrink_to_fit();
+  check_shrunk(c);
+}
+
+template <class C>
+void test() {
+  const C empty;
+  check(empty);
+
+  for_each_deque_shape(testN<C>);
+}
+
+int main(int, char**) {
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<block_int<16> > >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<int, min_allocator<int> > >();
+#endif
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// void reserve_back(size_type n);
+
+//  Allocates the blocks, and grows the map, so that capacity_back() >= n.
+//  The next n push_back or emplace_back calls then do not allocate. Throws
+//  length_error if n > max_size() - size().
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+
+#include "test_macros.h"
+#include "count_new.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+
+template <class C>
+void test(C& c, int n) {
+  typedef typename C::size_type S;
+  typedef typename C::value_type T;
+  const int size = static_cast<int>(c.size());
+  const T* first = size != 0 ? &c.front() : nullptr;
+  c.reserve_back(static_cast<S>(n));
+  assert(c.capacity_back() >= static_cast<S>(n));
+  assert(static_cast<int>(c.size()) == size);
+  for (int i = 0; i < size; ++i)
+    assert(c[i] == i);
+  if (size != 0)
+    assert(&c.front() == first);
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+
+  // Reserving no more than is already available does not allocate.
+  {
+    DisableAllocationGuard g;
+    c.reserve_back(static_cast<S>(n));
+    c.reserve_back(0);
+  }
+
+  {
+    DisableAllocationGuard g;
+    for (int i = 0; i < n; ++i) {
+      if (i % 2 == 0)
+        c.push_back(size + i);
+      else
+        c.emplace_back(size + i);
+      assert(c.capacity_back() >= static_cast<S>(n - i - 1));
+    }
+  }
+  assert(static_cast<int>(c.size()) == size + n);
+  for (int i = 0; i < size + n; ++i)
+    assert(c[i] == i);
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+template <class C>
+void testN(int start, int N) {
+  const int b = deque_block_elements<C>();
+  int rng[]   = {0, 1, b - 1, b, b + 1, 3 * b + 1};
+  for (int n : rng) {
+    C c = make_deque<C>(N, start);
+    test(c, n);
+  }
+}
+
+template <class C>
+void test() {
+  for_each_deque_shape(testN<C>);
+
+#ifndef TEST_HAS_NO_EXCEPTIONS
+  C c = make_deque<C>(10);
+  try {
+    c.reserve_back(c.max_size());
+    assert(false);
+  } catch (const std::length_error&) {
+  }
+  assert(c.size() == 10);
+  for (int i = 0; i < 10; ++i)
+    assert(c[i] == i);
+#endif
+}
+
+int main(int, char**) {
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<block_int<16> > >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<int, min_allocator<int> > >();
+#endif
+
+  return 0;
+}
@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+
+// "deque.hpp"
+
+// deque& operator=(const deque& c);
+// deque& operator=(initializer_list<value_type> il);
+// template <class InputIterator>
+//   void assign(InputIterator f, InputIterator l);
+// void assign(size_type n, const value_type& v);
+// void assign(initializer_list<value_type> il);
+// template<container-compatible-range<T> R>
+//   void assign_range(R&& rg);
+
+//  Assignment reuses what the deque already holds: the elements it keeps are
+//  copy-assigned in place, new ones are constructed into the free slots after
+//  the last element, and only the blocks still missing are allocated.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+#include "test_macros.h"
+#include "count_new.h"
+#include "deque_block_size.h"
+#include "test_allocator.h"
+#include "test_iterators.h"
+
+enum assignment { copy_assign, iter_iter, input_iter, size_value, range };
+
+template <class C>
+void assign(C& c, assignment how, const C& src, const std::vector<int>& v) {
+  switch (how) {
+  case copy_assign:
+    c = src;
+    break;
+  case iter_iter:
+    c.assign(v.begin(), v.end());
+    break;
+  case input_iter:
+    c.assign(cpp17_input_iterator<const int*>(v.data()), cpp17_input_iterator<const int*>(v.data() + v.size()));
+    break;
+  case size_value:
+    c.assign(v.size(), v.empty() ? 0 : v.front());
+    break;
+  case range:
+    c.assign_range(v);
+    break;
+  }
+}
+
+template <class T>
+void test(int start, int M, int N, assignment how) {
+  typedef test_allocator<T> A;
+  typedef bizwen::deque<T, A> C;
+  const int b = deque_block_elements<C>();
+  test_allocator_statistics stats;
+  {
+    std::vector<int> v;
+    for (int i = 0; i < N; ++i)
+      v.push_back(how == size_value ? 1000 : 1000 + i);
+    const C src(v.begin(), v.end(), A(&stats));
+    C c = make_deque<C>(M, start, A(&stats));
+
+    // The blocks assignment cannot do without, allowing one map reallocation
+    // on top of them.
+    const int room    = M + static_cast<int>(c.capacity_back());
+    const int missing = N > room ? (N - room + b - 1) / b : 0;
+
+    const int constructed = stats.construct_count;
+    const int destroyed   = stats.destroy_count;
+    globalMemCounter.reset();
+    assign(c, how, src, v);
+    if (missing == 0)
+      assert(globalMemCounter.checkNewCalledEq(0));
+    else
+      assert(!globalMemCounter.checkNewCalledGreaterThan(missing + 1));
+    assert(stats.construct_count - constructed == (N > M ? N - M : 0));
+    assert(stats.destroy_count - destroyed == (M > N ? M - N : 0));
+
+    assert(static_cast<int>(c.size()) == N);
+    for (int i = 0; i < N; ++i)
+      assert(c[i] == v[i]);
+    LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+  }
+  assert(stats.alloc_count == 0);
+}
+
+template <class T>
+void test() {
+  typedef bizwen::deque<T, test_allocator<T> > C;
+  const int b = deque_block_elements<C>();
+  int rng[]   = {0, 1, 2, b - 1, b, b + 1, 2 * b - 1, 2 * b, 2 * b + 1};
+  for (int start : rng)
+    for (int M : rng)
+      for (int N : rng)
+        for (assignment how : {copy_assign, iter_iter, input_iter, size_value, range})
+          test<T>(start, M, N, how);
+}
+
+// The initializer_list forms go through the same path.
+void test_initializer_list() {
+  typedef test_allocator<int> A;
+  typedef bizwen::deque<int, A> C;
+  test_allocator_statistics stats;
+  {
+    C c = make_deque<C>(10, 3, A(&stats));
+    const int constructed = stats.construct_count;
+    const int destroyed   = stats.destroy_count;
+    globalMemCounter.reset();
+
+    c = {3, 4, 5, 6};
+    assert(stats.construct_count == constructed);
+    assert(stats.destroy_count - destroyed == 6);
+    c.assign({7, 8, 9, 10, 11, 12});
+    assert(stats.construct_count - constructed == 2);
+    assert(globalMemCounter.checkNewCalledEq(0));
+    assert(c.size() == 6);
+    for (int i = 0; i < 6; ++i)
+      assert(c[i] == 7 + i);
+    LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+  }
+  assert(stats.alloc_count == 0);
+}
+
+int main(int, char**) {
+  test<int>();
+  test<block_int<16> >();
+  test_initializer_list();
+
+  return 0;
+}
@@ -0,0 +1,194 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// UNSUPPORTED: c++03, c++11, c++14, c++17
+
+// "deque.hpp"
+
+// template <class T, class Allocator, class U>
+//   typename deque<T, Allocator>::size_type
+//   erase(deque<T, Allocator>& c, const U& value);
+// template <class T, class Allocator, class Predicate>
+//   typename deque<T, Allocator>::size_type
+//   erase_if(deque<T, Allocator>& c, Predicate pred);
+
+//  Both make one pass over the deque, a block at a time, moving the elements
+//  that are kept towards the front in their order and calling pred once per
+//  element. The tail left behind is destroyed at once and the blocks it
+//  emptied are freed, apart from the spare ones the deque keeps. The front of
+//  the deque does not move. Trivially copyable elements are compacted with
+//  vector instructions where the target has them.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "test_macros.h"
+#include "count_new.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+
+// Counts its live instances, and is not trivially copyable.
+struct Counted {
+  static int live;
+  int value;
+
+  Counted(int v = 0) : value(v) { ++live; }
+  Counted(const Counted& other) : value(other.value) { ++live; }
+  Counted& operator=(const Counted&) = default;
+  ~Counted() { --live; }
+
+  operator int() const { return value; }
+};
+
+int Counted::live = 0;
+
+// An int whose deques keep no spare blocks, so that every block emptied by
+// erase_if is freed.
+struct Unspared {
+  int value;
+
+  Unspared(int v = 0) : value(v) {}
+
+  operator int() const { return value; }
+};
+
+namespace bizwen {
+template <>
+struct deque_block_traits<Unspared> {
+  static constexpr std::size_t block_elements   = 16;
+  static constexpr std::size_t max_spare_blocks = 0;
+};
+} // namespace bizwen
+
+// Whether the element at index i is erased, for several fractions and layouts
+// of the erased elements. pred counts its calls to find the index, since the
+// values of a deque<char> wrap around.
+bool erased(int pattern, int i, int N, int b) {
+  const unsigned h = static_cast<unsigned>(i) * 2654435761u >> 16;
+  switch (pattern) {
+  case 0:
+    return false;
+  case 1:
+    return true;
+  case 2:
+    return i % 2 == 0;
+  case 3:
+    return h % 100 < 30;
+  case 4:
+    return h % 100 < 70;
+  case 5:
+    // A run across the block boundaries in the middle.
+    return i >= N / 3 && i < N / 3 + 2 * b + 1;
+  case 6:
+    return i < b;
+  default:
+    return i >= N - b;
+  }
+}
+
+const int patterns = 8;
+
+template <class C>
+void testN(int start, int N) {
+  typedef typename C::value_type T;
+  const int b = deque_block_elements<C>();
+  for (int p = 0; p < patterns; ++p) {
+    C c = make_deque<C>(N, start);
+    const std::vector<int> before(c.begin(), c.end());
+    std::vector<int> model;
+    for (int i = 0; i < N; ++i)
+      if (!erased(p, i, N, b))
+        model.push_back(before[i]);
+    const std::size_t want  = before.size() - model.size();
+    const std::size_t front = c.capacity_front();
+
+    std::vector<int> seen;
+    int i               = 0;
+    const std::size_t n = bizwen::erase_if(c, [&](const T& x) {
+      seen.push_back(x);
+      return erased(p, i++, N, b);
+    });
+    assert(n == want);
+    // pred saw every element once, in order.
+    assert(seen == before);
+    assert(c.size() == model.size());
+    assert(std::equal(c.begin(), c.end(), model.begin()));
+    if (!c.empty())
+      assert(c.capacity_front() == front);
+    LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+  }
+
+  C c = make_deque<C>(N, start);
+  std::vector<int> model(c.begin(), c.end());
+  const T value       = T(N / 2);
+  const std::size_t n = bizwen::erase(c, value);
+  assert(n == std::erase(model, static_cast<int>(value)));
+  assert(c.size() == model.size());
+  assert(std::equal(c.begin(), c.end(), model.begin()));
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+template <class C>
+void test() {
+  for_each_deque_shape(testN<C>);
+}
+
+// The elements erased and the ones left behind by the compaction are all
+// destroyed.
+void test_destroyed() {
+  typedef bizwen::deque<Counted> C;
+  const int b = deque_block_elements<C>();
+  for (int p = 0; p < patterns; ++p) {
+    {
+      C c                 = make_deque<C>(5000, 17);
+      int i               = 0;
+      const std::size_t n = bizwen::erase_if(c, [&](const Counted&) { return erased(p, i++, 5000, b); });
+      assert(Counted::live == static_cast<int>(c.size()));
+      assert(c.size() + n == 5000);
+    }
+    assert(Counted::live == 0);
+  }
+}
+
+// Without spare blocks, no empty block is left at the back, and erasing
+// never allocates.
+void test_blocks() {
+  typedef bizwen::deque<Unspared> C;
+  const int b = deque_block_elements<C>();
+  int rng[]   = {1, b - 1, b, b + 1, 100 * b + 3};
+  for (int N : rng) {
+    for (int p = 0; p < patterns; ++p) {
+      C c   = make_deque<C>(N, 5);
+      int i = 0;
+      globalMemCounter.reset();
+      bizwen::erase_if(c, [&](const Unspared&) { return erased(p, i++, N, b); });
+      assert(globalMemCounter.checkNewCalledEq(0));
+      assert(c.capacity_back() < static_cast<std::size_t>(b));
+      LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+    }
+  }
+}
+
+int main(int, char**) {
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<char> >();
+  test<bizwen::deque<long long> >();
+  test<bizwen::deque<block_int<16> > >();
+  test<bizwen::deque<Counted> >();
+  test<bizwen::deque<Unspared> >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<int, min_allocator<int> > >();
+#endif
+  test_destroyed();
+  test_blocks();
+
+  return 0;
+}
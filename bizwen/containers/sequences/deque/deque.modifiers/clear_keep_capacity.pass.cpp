@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// void clear_keep_capacity() noexcept;
+
+//  Destroys the elements but keeps the blocks and the map, so that a deque
+//  reused as a scratch buffer can be refilled to its previous size without
+//  allocating. clear() is unchanged; release() gives the memory back.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+
+#include "test_macros.h"
+#include "count_new.h"
+#include "deque_block_size.h"
+#include "test_allocator.h"
+
+template <class T>
+void testN(int start, int N) {
+  typedef test_allocator<T> A;
+  typedef bizwen::deque<T, A> C;
+  typedef typename C::size_type S;
+  const S b = static_cast<S>(deque_block_elements<C>());
+  test_allocator_statistics stats;
+  {
+    C c                  = make_deque<C>(N, start, A(&stats));
+    const S blocks       = c.block_count();
+    const int live       = stats.alloc_count;
+    const int size       = stats.allocated_size;
+    const int destroyed  = stats.destroy_count;
+
+    ASSERT_NOEXCEPT(c.clear_keep_capacity());
+    c.clear_keep_capacity();
+    assert(c.empty());
+    assert(c.begin() == c.end());
+    assert(c.block_count() == blocks);
+    assert(c.capacity_front() + c.capacity_back() == blocks * b);
+    assert(stats.alloc_count == live);
+    assert(stats.allocated_size == size);
+    assert(stats.destroy_count == destroyed + N);
+    LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+
+    // Refilling to the previous size, again and again, reuses the blocks.
+    globalMemCounter.reset();
+    for (int round = 0; round < 4; ++round) {
+      for (int i = 0; i < N; ++i)
+        c.push_back(round + i);
+      assert(static_cast<int>(c.size()) == N);
+      for (int i = 0; i < N; ++i)
+        assert(c[i] == round + i);
+      LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+      c.clear_keep_capacity();
+      assert(c.empty());
+      LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+    }
+    assert(globalMemCounter.checkNewCalledEq(0));
+    assert(globalMemCounter.checkDeleteCalledEq(0));
+    assert(stats.alloc_count == live);
+    assert(stats.allocated_size == size);
+
+    // Clearing an empty deque changes nothing.
+    c.clear_keep_capacity();
+    assert(c.empty());
+    assert(c.block_count() == blocks);
+  }
+  assert(stats.alloc_count == 0);
+  assert(stats.allocated_size == 0);
+}
+
+template <class T>
+void test() {
+  int rng[]   = {0, 1, 2, 3, 1023, 1024, 1025, 2047, 2048, 2049};
+  const int N = sizeof(rng) / sizeof(rng[0]);
+  for (int i = 0; i < N; ++i)
+    for (int j = 0; j < N; ++j)
+      testN<T>(rng[i], rng[j]);
+}
+
+int main(int, char**) {
+  test<int>();
+  test<block_int<16> >();
+
+  return 0;
+}
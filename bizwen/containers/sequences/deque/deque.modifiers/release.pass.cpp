@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// void release() noexcept;
+
+//  Destroys the elements and deallocates every block, spare blocks included,
+//  and the map. The deque is then empty and can be used again.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+#include "test_allocator.h"
+
+template <class T>
+void testN(int start, int N) {
+  typedef test_allocator<T> A;
+  typedef bizwen::deque<T, A> C;
+  test_allocator_statistics stats;
+  {
+    C c = make_deque<C>(N, start, A(&stats));
+    ASSERT_NOEXCEPT(c.release());
+    const int destroyed = stats.destroy_count;
+    c.release();
+    assert(c.empty());
+    assert(c.begin() == c.end());
+    assert(c.block_count() == 0);
+    assert(c.capacity_front() == 0);
+    assert(c.capacity_back() == 0);
+    assert(stats.destroy_count == destroyed + N);
+    assert(stats.alloc_count == 0);
+    assert(stats.allocated_size == 0);
+    LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+
+    // Blocks kept by clear_keep_capacity() and by reserve_back() are given
+    // back as well.
+    for (int i = 0; i < N; ++i)
+      c.push_back(i);
+    c.clear_keep_capacity();
+    c.reserve_back(static_cast<typename C::size_type>(N + 1));
+    c.release();
+    assert(c.block_count() == 0);
+    assert(stats.alloc_count == 0);
+
+    c.push_front(1);
+    c.push_back(2);
+    assert(c.size() == 2);
+    assert(c.front() == 1);
+    assert(c.back() == 2);
+    LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+    c.release();
+    c.release();
+    assert(c.empty());
+  }
+  assert(stats.alloc_count == 0);
+}
+
+template <class T>
+void test() {
+  int rng[]   = {0, 1, 2, 3, 1023, 1024, 1025, 2047, 2048, 2049};
+  const int N = sizeof(rng) / sizeof(rng[0]);
+  for (int i = 0; i < N; ++i)
+    for (int j = 0; j < N; ++j)
+      testN<T>(rng[i], rng[j]);
+}
+
+int main(int, char**) {
+  test<int>();
+  test<block_int<16> >();
+
+  return 0;
+}
@@ -0,0 +1,275 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+
+// "deque.hpp"
+
+// template<container-compatible-range<T> R>
+//   void append_range(R&& rg);
+// template<container-compatible-range<T> R>
+//   void prepend_range(R&& rg);
+// template<container-compatible-range<T> R>
+//   iterator insert_range(const_iterator position, R&& rg);
+
+//  For a sized range every block the new elements need is allocated, and the
+//  map grown, before any element is constructed. The map is therefore
+//  reallocated at most once, and a failed allocation leaves the deque as it
+//  was. Trivially copyable elements read from a contiguous range are copied
+//  into each block with memcpy.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <new>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+
+struct allocation_log {
+  static int blocks;
+  static int others;
+  static int fail_after;
+
+  static void reset() {
+    blocks     = 0;
+    others     = 0;
+    fail_after = -1;
+  }
+};
+
+int allocation_log::blocks     = 0;
+int allocation_log::others     = 0;
+int allocation_log::fail_after = -1;
+
+// Counts the requests for Elem, which are blocks, apart from the others, which
+// are the map. Once fail_after requests have been served the next one throws.
+template <class T, class Elem>
+struct counting_allocator {
+  typedef T value_type;
+
+  counting_allocator() = default;
+  template <class U>
+  counting_allocator(const counting_allocator<U, Elem>&) {}
+
+  T* allocate(std::size_t n) {
+    if (allocation_log::fail_after == 0)
+      throw std::bad_alloc();
+    if (allocation_log::fail_after > 0)
+      --allocation_log::fail_after;
+    if (std::is_same<T, Elem>::value)
+      ++allocation_log::blocks;
+    else
+      ++allocation_log::others;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* p, std::size_t n) { std::allocator<T>().deallocate(p, n); }
+
+  template <class U>
+  friend bool operator==(const counting_allocator&, const counting_allocator<U, Elem>&) {
+    return true;
+  }
+};
+
+// c holds 0, ..., N - 1 with 1000, ..., 1000 + n - 1 inserted at pos.
+template <class C>
+void check(const C& c, int N, int pos, int n) {
+  assert(static_cast<int>(c.size()) == N + n);
+  for (int i = 0; i < N + n; ++i) {
+    if (i < pos)
+      assert(c[i] == i);
+    else if (i < pos + n)
+      assert(c[i] == 1000 + i - pos);
+    else
+      assert(c[i] == i - n);
+  }
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+// Inserts r, which holds 1000, ..., 1000 + n - 1, at pos into a deque holding
+// N elements starting at offset start in its first block.
+template <class C, class R>
+void test_insert(int start, int N, int pos, R&& r) {
+  const int b = deque_block_elements<C>();
+  const int n = static_cast<int>(std::ranges::size(r));
+  C c         = make_deque<C>(N, start);
+  allocation_log::reset();
+  if (pos == 0)
+    c.prepend_range(r);
+  else if (pos == N)
+    c.append_range(r);
+  else {
+    typename C::iterator it = c.insert_range(c.begin() + pos, r);
+    assert(it == c.begin() + pos);
+  }
+  assert(allocation_log::others <= 1);
+  assert(allocation_log::blocks <= n / b + 1);
+  check(c, N, pos, n);
+
+  // Whichever allocation fails, nothing has been constructed yet.
+  for (int k = 0; k < 4; ++k) {
+    C d = make_deque<C>(N, start);
+    allocation_log::reset();
+    allocation_log::fail_after = k;
+    try {
+      d.insert_range(d.begin() + pos, r);
+      allocation_log::fail_after = -1;
+      check(d, N, pos, n);
+    } catch (const std::bad_alloc&) {
+      allocation_log::fail_after = -1;
+      check(d, N, 0, 0);
+    }
+  }
+}
+
+template <class C>
+void test(int start, int N, int n) {
+  std::vector<int> v;
+  std::list<int> l;
+  for (int i = 0; i < n; ++i) {
+    v.push_back(1000 + i);
+    l.push_back(1000 + i);
+  }
+  int positions[] = {0, N / 2, N};
+  for (int pos : positions) {
+    test_insert<C>(start, N, pos, v);
+    test_insert<C>(start, N, pos, l);
+    test_insert<C>(start, N, pos, std::views::iota(1000, 1000 + n));
+  }
+
+  // A range that is not sized still works, one element at a time.
+  C c = make_deque<C>(N, start);
+  c.append_range(std::views::iota(1000) | std::views::take_while([n](int x) { return x < 1000 + n; }));
+  check(c, N, N, n);
+}
+
+int dereferences = 0;
+
+// A contiguous iterator that counts the elements read through operator*.
+// operator->, which std::to_address goes through, does not count, so a range
+// copied with memcpy is read without any.
+template <class T>
+struct counting_contiguous_iterator {
+  typedef std::contiguous_iterator_tag iterator_concept;
+  typedef std::random_access_iterator_tag iterator_category;
+  typedef T value_type;
+  typedef T element_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef T* pointer;
+  typedef T& reference;
+
+  T* p = nullptr;
+
+  counting_contiguous_iterator() = default;
+  explicit counting_contiguous_iterator(T* q) : p(q) {}
+
+  T& operator*() const {
+    ++dereferences;
+    return *p;
+  }
+  T* operator->() const { return p; }
+  T& operator[](std::ptrdiff_t n) const { return *(*this + n); }
+
+  counting_contiguous_iterator& operator++() {
+    ++p;
+    return *this;
+  }
+  counting_contiguous_iterator operator++(int) { return counting_contiguous_iterator(p++); }
+  counting_contiguous_iterator& operator--() {
+    --p;
+    return *this;
+  }
+  counting_contiguous_iterator operator--(int) { return counting_contiguous_iterator(p--); }
+  counting_contiguous_iterator& operator+=(std::ptrdiff_t n) {
+    p += n;
+    return *this;
+  }
+  counting_contiguous_iterator& operator-=(std::ptrdiff_t n) {
+    p -= n;
+    return *this;
+  }
+  friend counting_contiguous_iterator operator+(counting_contiguous_iterator it, std::ptrdiff_t n) { return it += n; }
+  friend counting_contiguous_iterator operator+(std::ptrdiff_t n, counting_contiguous_iterator it) { return it += n; }
+  friend counting_contiguous_iterator operator-(counting_contiguous_iterator it, std::ptrdiff_t n) { return it -= n; }
+  friend std::ptrdiff_t operator-(counting_contiguous_iterator x, counting_contiguous_iterator y) { return x.p - y.p; }
+  friend bool operator==(counting_contiguous_iterator x, counting_contiguous_iterator y) { return x.p == y.p; }
+  friend auto operator<=>(counting_contiguous_iterator x, counting_contiguous_iterator y) { return x.p <=> y.p; }
+};
+
+static_assert(std::contiguous_iterator<counting_contiguous_iterator<int> >);
+
+// Not trivially copyable, so each element is copy-constructed from *it.
+struct NotTriviallyCopyable {
+  int value;
+
+  NotTriviallyCopyable(int v = 0) : value(v) {}
+  NotTriviallyCopyable(const NotTriviallyCopyable& other) : value(other.value) {}
+  NotTriviallyCopyable& operator=(const NotTriviallyCopyable&) = default;
+
+  operator int() const { return value; }
+};
+
+// Inserts n elements from a contiguous range at the front, middle and back,
+// each of which is read through operator* reads_per_element times.
+template <class T>
+void test_contiguous(int start, int N, int n, int reads_per_element) {
+  typedef bizwen::deque<T, counting_allocator<T, T> > C;
+  std::vector<T> v;
+  for (int i = 0; i < n; ++i)
+    v.push_back(T(1000 + i));
+  std::ranges::subrange<counting_contiguous_iterator<T> > r(
+      counting_contiguous_iterator<T>(v.data()), counting_contiguous_iterator<T>(v.data() + n));
+  int positions[] = {0, N / 2, N};
+  for (int pos : positions) {
+    C c          = make_deque<C>(N, start);
+    dereferences = 0;
+    c.insert_range(c.begin() + pos, r);
+    assert(dereferences == reads_per_element * n);
+    check(c, N, pos, n);
+  }
+}
+
+template <class T>
+void test_contiguous(int reads_per_element) {
+  const int b   = deque_block_elements<bizwen::deque<T> >();
+  int rng[]     = {0, 1, b - 1, b + 1};
+  int lengths[] = {0, 1, b - 1, b, b + 1, 3 * b};
+  for (int start : rng)
+    for (int N : rng)
+      for (int n : lengths)
+        test_contiguous<T>(start, N, n, reads_per_element);
+}
+
+template <class T>
+void test() {
+  typedef bizwen::deque<T, counting_allocator<T, T> > C;
+  const int b   = deque_block_elements<C>();
+  int rng[]     = {0, 1, b - 1, b, b + 1, 2 * b + 1};
+  int lengths[] = {0, 1, b - 1, b, b + 1, 3 * b, 10 * b + 1};
+  for (int start : rng)
+    for (int N : rng)
+      for (int n : lengths)
+        test<C>(start, N, n);
+}
+
+int main(int, char**) {
+  test<int>();
+  test<block_int<16> >();
+
+  test_contiguous<int>(0);
+  test_contiguous<block_int<16> >(0);
+  test_contiguous<NotTriviallyCopyable>(1);
+
+  return 0;
+}
@@ -0,0 +1,254 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// template <class T>
+// struct deque_block_traits {
+//   static constexpr size_type max_spare_blocks;
+// };
+//
+// template <class T, class Allocator>
+// class deque {
+//   static constexpr size_type max_spare_blocks;
+// };
+
+//  Blocks emptied by pop_front, pop_back and erase are kept, up to
+//  max_spare_blocks of them, and reused by push_*, emplace_* and insert, so
+//  that a queue that does not grow reaches a state where it never allocates.
+//  A specialization that leaves max_spare_blocks out gets the default of 4,
+//  which bizwen::deque<T>::max_spare_blocks reports.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+#include <memory>
+
+#include "test_macros.h"
+#include "count_new.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+
+struct Bounded {
+  int value;
+
+  Bounded(int v = 0) : value(v) {}
+
+  operator int() const { return value; }
+};
+
+struct Uncached {
+  int value;
+
+  Uncached(int v = 0) : value(v) {}
+
+  operator int() const { return value; }
+};
+
+namespace bizwen {
+template <>
+struct deque_block_traits<Bounded> {
+  static constexpr std::size_t block_elements   = 16;
+  static constexpr std::size_t max_spare_blocks = 2;
+};
+
+template <>
+struct deque_block_traits<Uncached> {
+  static constexpr std::size_t block_elements   = 16;
+  static constexpr std::size_t max_spare_blocks = 0;
+};
+} // namespace bizwen
+
+static_assert(bizwen::deque<int>::max_spare_blocks == 4);
+static_assert(bizwen::deque<block_int<16> >::max_spare_blocks == 4);
+static_assert(bizwen::deque<Bounded>::max_spare_blocks == 2);
+static_assert(bizwen::deque<Uncached>::max_spare_blocks == 0);
+
+template <class C>
+void test_push_back_pop_front(int window) {
+  const int b = deque_block_elements<C>();
+  int next    = 0;
+  C c;
+  for (int i = 0; i < window; ++i)
+    c.push_back(next++);
+  // Let the deque settle its map and spare blocks before counting.
+  for (int i = 0; i < 4 * b; ++i) {
+    c.push_back(next++);
+    c.pop_front();
+  }
+  globalMemCounter.reset();
+  for (int i = 0; i < 16 * b; ++i) {
+    c.push_back(next++);
+    c.pop_front();
+  }
+  assert(globalMemCounter.checkNewCalledEq(0));
+  assert(static_cast<int>(c.size()) == window);
+  for (int i = 0; i < window; ++i)
+    assert(c[i] == next - window + i);
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+template <class C>
+void test_push_front_pop_back(int window) {
+  const int b = deque_block_elements<C>();
+  int next    = 0;
+  C c;
+  for (int i = 0; i < window; ++i)
+    c.push_front(next++);
+  for (int i = 0; i < 4 * b; ++i) {
+    c.push_front(next++);
+    c.pop_back();
+  }
+  globalMemCounter.reset();
+  for (int i = 0; i < 16 * b; ++i) {
+    c.emplace_front(next++);
+    c.pop_back();
+  }
+  assert(globalMemCounter.checkNewCalledEq(0));
+  assert(static_cast<int>(c.size()) == window);
+  for (int i = 0; i < window; ++i)
+    assert(c[i] == next - 1 - i);
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+template <class C>
+void test_emplace_back_erase(int window) {
+  const int b = deque_block_elements<C>();
+  C c;
+  for (int i = 0; i < window; ++i)
+    c.emplace_back(i);
+  for (int i = 0; i < 4 * b; ++i) {
+    c.emplace_back(i);
+    c.erase(c.begin());
+  }
+  globalMemCounter.reset();
+  for (int i = 0; i < 16 * b; ++i) {
+    c.emplace_back(i);
+    c.erase(c.begin());
+  }
+  assert(globalMemCounter.checkNewCalledEq(0));
+  assert(static_cast<int>(c.size()) == window);
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+template <class C>
+void test() {
+  int rng[]   = {1, 2, 15, 16, 17, 1023, 1024, 1025, 2047, 2048, 2049};
+  const int N = sizeof(rng) / sizeof(rng[0]);
+  for (int i = 0; i < N; ++i) {
+    test_push_back_pop_front<C>(rng[i]);
+    test_push_front_pop_back<C>(rng[i]);
+    test_emplace_back_erase<C>(rng[i]);
+  }
+}
+
+// Counts the blocks it hands out, which are its only allocations for the
+// element type itself; the map is allocated through a rebound copy.
+template <class T>
+struct block_counting_allocator {
+  typedef T value_type;
+
+  static int live;
+  static int freed;
+
+  block_counting_allocator() = default;
+  template <class U>
+  block_counting_allocator(const block_counting_allocator<U>&) {}
+
+  T* allocate(std::size_t n) {
+    ++live;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* p, std::size_t n) {
+    --live;
+    ++freed;
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  template <class U>
+  friend bool operator==(const block_counting_allocator&, const block_counting_allocator<U>&) {
+    return true;
+  }
+};
+
+template <class T>
+int block_counting_allocator<T>::live = 0;
+template <class T>
+int block_counting_allocator<T>::freed = 0;
+
+// Draining a deque keeps exactly max_spare_blocks of the blocks it empties
+// and gives the others back to the allocator straight away. Refilling it
+// with no more elements than those blocks hold, wherever begin() was left
+// inside them, allocates nothing.
+void test_high_water_mark() {
+  typedef block_counting_allocator<Bounded> A;
+  typedef bizwen::deque<Bounded, A> C;
+  const int b     = deque_block_elements<C>();
+  const int spare = static_cast<int>(bizwen::deque_block_traits<Bounded>::max_spare_blocks);
+  for (int start = 0; start < b; start += 5) {
+    C c;
+    for (int i = 0; i < start; ++i)
+      c.push_back(i);
+    for (int i = 0; i < start; ++i)
+      c.pop_front();
+    for (int i = 0; i < 16 * b; ++i)
+      c.push_back(i);
+    const int blocks = A::live;
+    assert(blocks >= 16);
+
+    A::freed = 0;
+    globalMemCounter.reset();
+    while (!c.empty())
+      c.pop_front();
+    assert(globalMemCounter.checkNewCalledEq(0));
+    assert(A::freed == blocks - spare);
+    assert(A::live == spare);
+    LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+
+    globalMemCounter.reset();
+    for (int i = 0; i < (spare - 1) * b + 1; ++i)
+      c.push_back(i);
+    assert(globalMemCounter.checkNewCalledEq(0));
+    assert(A::live == spare);
+    for (int i = 0; i < (spare - 1) * b + 1; ++i)
+      assert(c[i] == i);
+    LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+  }
+  assert(A::live == 0);
+}
+
+// With no spare blocks every block that is emptied is freed, so the same
+// traffic keeps allocating.
+void test_uncached() {
+  typedef bizwen::deque<Uncached> C;
+  const int b = deque_block_elements<C>();
+  C c;
+  for (int i = 0; i < b; ++i)
+    c.push_back(i);
+  globalMemCounter.reset();
+  for (int i = 0; i < 16 * b; ++i) {
+    c.push_back(i);
+    c.pop_front();
+  }
+  assert(globalMemCounter.checkNewCalledGreaterThan(0));
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+int main(int, char**) {
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<block_int<16> > >();
+  test<bizwen::deque<Bounded> >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<int, min_allocator<int> > >();
+#endif
+  test_high_water_mark();
+  test_uncached();
+
+  return 0;
+}
@@ -0,0 +1,214 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// template <class T>
+// struct is_trivially_relocatable;
+// template <class T>
+//   constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+//  insert, emplace and erase in the middle shift the elements between the
+//  position and the nearer end. For trivially relocatable elements the shift
+//  moves their bytes and never calls a constructor or assignment operator.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+
+struct operation_counts {
+  static int copies;
+  static int moves;
+
+  static void reset() {
+    copies = 0;
+    moves  = 0;
+  }
+};
+
+int operation_counts::copies = 0;
+int operation_counts::moves  = 0;
+
+// Counts its copies and moves, and is not trivially copyable because of them.
+// Relocatable opts in to the byte-wise shifts, Pinned does not.
+template <int Tag>
+struct Counted {
+  int value;
+
+  Counted(int v = 0) : value(v) {}
+  Counted(const Counted& other) : value(other.value) { ++operation_counts::copies; }
+  Counted(Counted&& other) : value(other.value) { ++operation_counts::moves; }
+  Counted& operator=(const Counted& other) {
+    value = other.value;
+    ++operation_counts::copies;
+    return *this;
+  }
+  Counted& operator=(Counted&& other) {
+    value = other.value;
+    ++operation_counts::moves;
+    return *this;
+  }
+  ~Counted() {}
+
+  operator int() const { return value; }
+};
+
+typedef Counted<0> Relocatable;
+typedef Counted<1> Pinned;
+
+namespace bizwen {
+template <>
+struct is_trivially_relocatable<Relocatable> : std::true_type {};
+
+template <int Tag>
+struct deque_block_traits<Counted<Tag> > {
+  static constexpr std::size_t block_elements = 16;
+};
+} // namespace bizwen
+
+struct Trivial {
+  int a;
+  double b;
+};
+
+static_assert(bizwen::is_trivially_relocatable<int>::value, "");
+static_assert(bizwen::is_trivially_relocatable_v<int*>, "");
+static_assert(bizwen::is_trivially_relocatable_v<Trivial>, "");
+static_assert(bizwen::is_trivially_relocatable_v<block_int<16> >, "");
+static_assert(bizwen::is_trivially_relocatable_v<Relocatable>, "");
+static_assert(!bizwen::is_trivially_relocatable_v<Pinned>, "");
+static_assert(!bizwen::is_trivially_relocatable_v<std::unique_ptr<int> >, "");
+static_assert(!bizwen::is_trivially_relocatable_v<std::string>, "");
+
+// c holds 0, ..., N - 1 with x inserted at pos.
+template <class C>
+void check_inserted(const C& c, int N, int pos, int x) {
+  assert(static_cast<int>(c.size()) == N + 1);
+  for (int i = 0; i < N + 1; ++i)
+    assert(c[i] == (i < pos ? i : i == pos ? x : i - 1));
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+// c holds 0, ..., N - 1 with [pos, pos + n) removed.
+template <class C>
+void check_erased(const C& c, int N, int pos, int n) {
+  assert(static_cast<int>(c.size()) == N - n);
+  for (int i = 0; i < N - n; ++i)
+    assert(c[i] == (i < pos ? i : i + n));
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+template <class C>
+void testN(int start, int N, bool relocatable) {
+  typedef typename C::value_type T;
+  int positions[] = {1, N / 3, N / 2, N - 1};
+  for (int pos : positions) {
+    if (pos < 1 || pos > N - 1)
+      continue;
+    // The number of elements between pos and the nearer end.
+    const int shifted = pos < N - pos ? pos : N - pos;
+    {
+      C c = make_deque<C>(N, start);
+      operation_counts::reset();
+      c.emplace(c.begin() + pos, -1);
+      check_inserted(c, N, pos, -1);
+      if (relocatable)
+        assert(operation_counts::copies == 0 && operation_counts::moves <= 1);
+      else
+        assert(operation_counts::moves >= shifted);
+    }
+    {
+      C c = make_deque<C>(N, start);
+      T x(-2);
+      operation_counts::reset();
+      c.insert(c.begin() + pos, x);
+      check_inserted(c, N, pos, -2);
+      if (relocatable)
+        assert(operation_counts::copies <= 1 && operation_counts::moves <= 1);
+      else
+        assert(operation_counts::copies + operation_counts::moves >= shifted);
+    }
+    {
+      C c = make_deque<C>(N, start);
+      operation_counts::reset();
+      c.erase(c.begin() + pos);
+      check_erased(c, N, pos, 1);
+      if (relocatable)
+        assert(operation_counts::copies == 0 && operation_counts::moves == 0);
+      else
+        assert(operation_counts::moves >= (pos < N - pos - 1 ? pos : N - pos - 1));
+    }
+    {
+      const int n = (N - pos) / 2;
+      C c         = make_deque<C>(N, start);
+      operation_counts::reset();
+      c.erase(c.begin() + pos, c.begin() + pos + n);
+      check_erased(c, N, pos, n);
+      if (relocatable)
+        assert(operation_counts::copies == 0 && operation_counts::moves == 0);
+    }
+  }
+}
+
+// Emplaces 64 blocks of elements at either end, far more than the map of a new
+// deque has room for. Growing the map moves the pointers to the blocks and
+// never an element.
+template <class C>
+void test_map_growth(int start, int N) {
+  const int b = deque_block_elements<C>();
+  {
+    C c = make_deque<C>(N, start);
+    operation_counts::reset();
+    for (int i = 0; i < 64 * b; ++i)
+      c.emplace_back(N + i);
+    assert(operation_counts::copies == 0 && operation_counts::moves == 0);
+    for (int i = 0; i < N + 64 * b; ++i)
+      assert(c[i] == i);
+    LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+  }
+  {
+    C c = make_deque<C>(N, start);
+    operation_counts::reset();
+    for (int i = 1; i <= 64 * b; ++i)
+      c.emplace_front(-i);
+    assert(operation_counts::copies == 0 && operation_counts::moves == 0);
+    for (int i = 0; i < N + 64 * b; ++i)
+      assert(c[i] == i - 64 * b);
+    LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+  }
+}
+
+template <class C>
+void test(bool relocatable) {
+  int rng[]   = {0, 1, 2, 3, 15, 16, 17, 31, 32, 33, 1023, 1024, 1025};
+  const int N = sizeof(rng) / sizeof(rng[0]);
+  for (int i = 0; i < N; ++i)
+    for (int j = 0; j < N; ++j)
+      testN<C>(rng[i], rng[j], relocatable);
+  if (relocatable)
+    for (int i = 0; i < N; ++i)
+      test_map_growth<C>(rng[i], rng[i]);
+}
+
+int main(int, char**) {
+  test<bizwen::deque<Relocatable> >(true);
+  test<bizwen::deque<Pinned> >(false);
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<Relocatable, min_allocator<Relocatable> > >(true);
+#endif
+
+  return 0;
+}
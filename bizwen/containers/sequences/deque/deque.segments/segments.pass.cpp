@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// segment_view<span<value_type>>       segments();
+// segment_view<span<const value_type>> segments() const;
+// template <class Iter>
+//   segment_view<...> segments(Iter first, Iter last);
+// segment_iterator iterator::segment() const;
+// value_type*      iterator::local() const;
+// const T*         const_iterator::local() const;
+
+//  segments() yields, in order, the contiguous runs of elements of [first, last),
+//  one per block. *it.segment() points to the first slot of the block holding
+//  it, and it.local() to the element itself.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <utility>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+
+// Walks the segments of [first, last) and checks that they cover exactly
+// those elements, in order, without empty segments and without crossing a
+// block.
+template <class C, class Iter, class Segments>
+void check_segments(Iter first, Iter last, Segments segs) {
+  const std::size_t b = static_cast<std::size_t>(deque_block_elements<C>());
+  std::size_t count   = 0;
+  Iter it             = first;
+  for (auto seg : segs) {
+    assert(!seg.empty());
+    assert(seg.size() <= b);
+    assert(seg.data() == it.local());
+    for (std::size_t i = 0; i < seg.size(); ++i, ++it)
+      assert(std::addressof(seg[i]) == std::addressof(*it));
+    ++count;
+  }
+  assert(it == last);
+  assert(static_cast<std::size_t>(std::ranges::distance(segs)) == count);
+  assert(segs.size() == count);
+  if (first == last)
+    assert(segs.empty());
+}
+
+template <class C>
+void test_iterator(const C& c) {
+  const int b = deque_block_elements<C>();
+  for (typename C::const_iterator it = c.begin(); it != c.end(); ++it) {
+    assert(it.local() == std::addressof(*it));
+    assert(*it.segment() <= it.local());
+    assert(it.local() < *it.segment() + b);
+    typename C::const_iterator next = std::next(it);
+    if (next == c.end())
+      break;
+    if (next.segment() == it.segment()) {
+      assert(next.local() == it.local() + 1);
+    } else {
+      assert(next.segment() == std::next(it.segment()));
+      assert(next.local() == *next.segment());
+    }
+  }
+}
+
+template <class C>
+void testN(int start, int N) {
+  C c = make_deque<C>(N, start);
+  check_segments<C>(c.begin(), c.end(), c.segments());
+  check_segments<C>(std::as_const(c).begin(), std::as_const(c).end(), std::as_const(c).segments());
+  test_iterator(c);
+
+  // Writing through the segments writes the deque.
+  for (auto seg : c.segments())
+    for (auto& x : seg)
+      x = x + 1;
+  for (int i = 0; i < N; ++i)
+    assert(c[i] == i + 1);
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+
+  // Arbitrary subranges, including empty ones and ones inside a single block.
+  for_each_subrange(N, [&](int first, int last) {
+    typename C::iterator f = c.begin() + first;
+    typename C::iterator l = c.begin() + last;
+    check_segments<C>(f, l, bizwen::segments(f, l));
+    typename C::const_iterator cf = f;
+    typename C::const_iterator cl = l;
+    check_segments<C>(cf, cl, bizwen::segments(cf, cl));
+  });
+}
+
+template <class C>
+void test() {
+  for_each_deque_shape(testN<C>);
+}
+
+int main(int, char**) {
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<block_int<16> > >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<int, min_allocator<int> > >();
+#endif
+
+  return 0;
+}
@@ -0,0 +1,54 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// Unqualified copy, move, copy_backward and move_backward on deque::iterators
+
+//  With an allocator from outside namespace std, std is not an associated
+//  namespace of the iterators, so unqualified calls find the segmented
+//  overloads alone, even with <algorithm> included. (With std::allocator the
+//  std algorithms are found as well, and bizwen:: has to be spelled out.)
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+
+typedef bizwen::deque<int, min_allocator<int> > C;
+
+void test(int start, int N) {
+  const C c1 = make_deque<C>(N, start);
+  C c2       = make_deque<C>(N, 0, [](int) { return -1; });
+  assert(copy(c1.begin(), c1.end(), c2.begin()) == c2.end());
+  assert(c1 == c2);
+
+  C c3 = make_deque<C>(N, start + 1, [](int) { return -1; });
+  assert(copy_backward(c1.begin(), c1.end(), c3.end()) == c3.begin());
+  assert(c1 == c3);
+
+  C c4 = make_deque<C>(N, 0, [](int) { return -1; });
+  assert(move(c2.begin(), c2.end(), c4.begin()) == c4.end());
+  assert(c1 == c4);
+
+  C c5 = make_deque<C>(N, start, [](int) { return -1; });
+  assert(move_backward(c3.begin(), c3.end(), c5.end()) == c5.begin());
+  assert(c1 == c5);
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c5));
+}
+
+int main(int, char**) {
+  for_each_deque_shape(test);
+
+  return 0;
+}
@@ -0,0 +1,207 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// UNSUPPORTED: c++03, c++11, c++14, c++17
+
+// "deque.hpp"
+
+// Segmented copy, move, copy_backward and move_backward for deque::iterators,
+// taken when first or result is a deque iterator
+
+// template <class InputIterator, class OutputIterator>
+//   OutputIterator
+//   copy(InputIterator first, InputIterator last, OutputIterator result);
+// template <class InputIterator, class OutputIterator>
+//   OutputIterator
+//   move(InputIterator first, InputIterator last, OutputIterator result);
+// template <class BidirectionalIterator1, class BidirectionalIterator2>
+//   BidirectionalIterator2
+//   copy_backward(BidirectionalIterator1 first, BidirectionalIterator1 last, BidirectionalIterator2 result);
+// template <class BidirectionalIterator1, class BidirectionalIterator2>
+//   BidirectionalIterator2
+//   move_backward(BidirectionalIterator1 first, BidirectionalIterator1 last, BidirectionalIterator2 result);
+
+//  The range is split at the block boundaries of both sides; trivially
+//  copyable elements are then copied or moved with one memmove per piece.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+
+// Not trivially copyable, so it takes the element-wise path. A moved-from
+// Movable holds -1, which shows that the elements were moved and not copied.
+struct Movable {
+  int value;
+
+  Movable(int v = 0) : value(v) {}
+  Movable(const Movable& other) : value(other.value) {}
+  Movable(Movable&& other) : value(other.value) { other.value = -1; }
+  Movable& operator=(const Movable& other) {
+    value = other.value;
+    return *this;
+  }
+  Movable& operator=(Movable&& other) {
+    value       = other.value;
+    other.value = -1;
+    return *this;
+  }
+
+  operator int() const { return value; }
+};
+
+namespace bizwen {
+template <>
+struct deque_block_traits<Movable> {
+  static constexpr std::size_t block_elements = 16;
+};
+} // namespace bizwen
+
+// Each algorithm called through bizwen::, with whether it moves and whether
+// result is the end of the destination rather than its beginning.
+struct Copy {
+  static const bool moves    = false;
+  static const bool backward = false;
+  template <class I, class O>
+  static O call(I first, I last, O result) {
+    return bizwen::copy(first, last, result);
+  }
+};
+
+struct Move {
+  static const bool moves    = true;
+  static const bool backward = false;
+  template <class I, class O>
+  static O call(I first, I last, O result) {
+    return bizwen::move(first, last, result);
+  }
+};
+
+struct CopyBackward {
+  static const bool moves    = false;
+  static const bool backward = true;
+  template <class I, class O>
+  static O call(I first, I last, O result) {
+    return bizwen::copy_backward(first, last, result);
+  }
+};
+
+struct MoveBackward {
+  static const bool moves    = true;
+  static const bool backward = true;
+  template <class I, class O>
+  static O call(I first, I last, O result) {
+    return bizwen::move_backward(first, last, result);
+  }
+};
+
+// Transfers [first, last) to the range beginning at dest, and checks the
+// iterator returned.
+template <class A, class I, class O>
+void transfer(I first, I last, O dest) {
+  const std::ptrdiff_t n = last - first;
+  if (A::backward)
+    assert(A::call(first, last, dest + n) == dest);
+  else
+    assert(A::call(first, last, dest) == dest + n);
+}
+
+// The element i of a source after [first, first + n) was transferred out of
+// it: still i, unless a Movable was moved from.
+template <class A, class C>
+int left_behind(int i, int first, int n) {
+  if (A::moves && std::is_same<typename C::value_type, Movable>::value && i >= first && i < first + n)
+    return -1;
+  return i;
+}
+
+template <class A, class C>
+void testN(int start, int N) {
+  typedef typename C::value_type T;
+  {
+    C c1 = make_deque<C>(N, start);
+    C c2 = make_deque<C>(N, 0, [](int) { return -2; });
+    transfer<A>(c1.begin(), c1.end(), c2.begin());
+    for (int i = 0; i < N; ++i) {
+      assert(c2[i] == i);
+      assert(c1[i] == (left_behind<A, C>(i, 0, N)));
+    }
+    LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c1));
+    LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c2));
+  }
+  {
+    // Deque to contiguous buffer and back.
+    C c1 = make_deque<C>(N, start);
+    std::vector<T> v(N, T(-2));
+    transfer<A>(c1.begin(), c1.end(), v.data());
+    for (int i = 0; i < N; ++i)
+      assert(v[i] == i);
+    C c2 = make_deque<C>(N, start + 1, [](int) { return -2; });
+    transfer<A>(v.data(), v.data() + N, c2.begin());
+    for (int i = 0; i < N; ++i)
+      assert(c2[i] == i);
+    LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c2));
+  }
+  if (!A::moves) {
+    // Through const_iterators.
+    const C c1 = make_deque<C>(N, start);
+    C c2       = make_deque<C>(N, 0, [](int) { return -2; });
+    transfer<A>(c1.cbegin(), c1.cend(), c2.begin());
+    assert(c1 == c2);
+  }
+
+  // Subranges whose block boundaries do not line up with the destination's.
+  for_each_subrange(N, [&](int first, int dest) {
+    for (int k = 0; k < 2; ++k) {
+      const int from = k == 0 ? first : dest;
+      const int to   = k == 0 ? dest : first;
+      const int n    = N - (from > to ? from : to);
+      C c3           = make_deque<C>(N, start);
+      C c4           = make_deque<C>(N);
+      transfer<A>(c3.begin() + from, c3.begin() + from + n, c4.begin() + to);
+      for (int i = 0; i < N; ++i) {
+        assert(c4[i] == (i >= to && i < to + n ? i - to + from : i));
+        assert(c3[i] == (left_behind<A, C>(i, from, n)));
+      }
+      LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c4));
+
+      // Within one deque, towards the front for copy and move and towards the
+      // back for the backward algorithms, so that result is outside the range.
+      if (A::backward ? to > from : to < from) {
+        C c5 = make_deque<C>(N, start);
+        transfer<A>(c5.begin() + from, c5.begin() + from + n, c5.begin() + to);
+        for (int i = to; i < to + n; ++i)
+          assert(c5[i] == i - to + from);
+        LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c5));
+      }
+    }
+  });
+}
+
+template <class A>
+void test() {
+  for_each_block_size([]<class C>() { for_each_deque_shape(testN<A, C>); });
+  for_each_deque_shape(testN<A, bizwen::deque<Movable> >);
+#if TEST_STD_VER >= 11
+  for_each_deque_shape(testN<A, bizwen::deque<int, min_allocator<int> > >);
+#endif
+}
+
+int main(int, char**) {
+  test<Copy>();
+  test<Move>();
+  test<CopyBackward>();
+  test<MoveBackward>();
+
+  return 0;
+}
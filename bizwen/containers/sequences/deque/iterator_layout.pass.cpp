@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// iterator, const_iterator
+
+//  An iterator is two words: a pointer into the map and the position of its
+//  element counted from the first block the deque allocated. Subtracting and
+//  comparing iterators only compares positions, and operator+= only adds to
+//  one, so none of them reads the map or a block.
+
+#include "deque.hpp"
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+
+template <class C>
+void test_layout() {
+  typedef typename C::iterator I;
+  typedef typename C::const_iterator CI;
+  static_assert(sizeof(I) == 2 * sizeof(void*), "");
+  static_assert(sizeof(CI) == 2 * sizeof(void*), "");
+  static_assert(std::is_trivially_copyable<I>::value, "");
+  static_assert(std::is_trivially_copyable<CI>::value, "");
+  static_assert(std::is_nothrow_default_constructible<I>::value, "");
+}
+
+// Every relational operator and the difference of the iterators at i and j
+// agree with i and j, mixing iterator and const_iterator.
+template <class C>
+void check_pair(C& c, int i, int j) {
+  typename C::iterator a        = c.begin() + i;
+  typename C::const_iterator cb = c.cbegin() + j;
+  typename C::iterator b        = c.begin() + j;
+  assert(a - b == i - j);
+  assert(a - cb == i - j);
+  assert(cb - a == j - i);
+  assert((a == b) == (i == j));
+  assert((a != cb) == (i != j));
+  assert((a < b) == (i < j));
+  assert((a <= cb) == (i <= j));
+  assert((cb > a) == (j > i));
+  assert((b >= a) == (j >= i));
+  assert((a <=> b) == (i <=> j));
+  assert((a <=> cb) == (i <=> j));
+  assert(a + (j - i) == b);
+  assert(b - (j - i) == a);
+  typename C::iterator k = a;
+  k += j - i;
+  assert(k == b);
+  k -= j - i;
+  assert(k == a);
+  if (j < static_cast<int>(c.size()))
+    assert(&*(a + (j - i)) == &c[j]);
+}
+
+template <class C>
+void testN(int start, int N) {
+  C c = make_deque<C>(N, start);
+  assert(c.end() - c.begin() == N);
+  assert(c.cend() - c.cbegin() == N);
+  assert(std::distance(c.begin(), c.end()) == N);
+  int positions[] = {0, 1, N / 3, N / 2, N - 1, N};
+  for (int i : positions)
+    for (int j : positions)
+      if (i >= 0 && j >= 0 && i <= N && j <= N)
+        check_pair(c, i, j);
+}
+
+template <class C>
+void test() {
+  test_layout<C>();
+
+  // Value-initialized iterators compare equal and are 0 apart.
+  typename C::iterator i1{};
+  typename C::iterator i2{};
+  typename C::const_iterator ci{};
+  assert(i1 == i2);
+  assert(i1 == ci);
+  assert(i1 - i2 == 0);
+  assert((i1 <=> ci) == std::strong_ordering::equal);
+
+  // An empty deque, whether it has never allocated or has been emptied.
+  C c;
+  assert(c.begin() == c.end());
+  assert(c.end() - c.begin() == 0);
+  c.push_back(1);
+  c.pop_back();
+  assert(c.begin() == c.end());
+  assert(c.end() - c.begin() == 0);
+
+  for_each_deque_shape(testN<C>);
+}
+
+int main(int, char**) {
+  test<bizwen::deque<int> >();
+  test<bizwen::deque<char> >();
+  test<bizwen::deque<block_int<1> > >();
+  test<bizwen::deque<block_int<16> > >();
+#if TEST_STD_VER >= 11
+  test<bizwen::deque<int, min_allocator<int> > >();
+#endif
+
+  return 0;
+}
@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17
+
+// segments(), segments() const, segments(first, last)
+
+#include "deque.hpp"
+
+#include <concepts>
+#include <iterator>
+#include <ranges>
+#include <span>
+
+using range         = bizwen::deque<int>;
+using segments      = decltype(std::declval<range&>().segments());
+using segments_sub  = decltype(bizwen::segments(std::declval<range::iterator>(), std::declval<range::iterator>()));
+using csegments     = decltype(std::declval<range const&>().segments());
+using csegments_sub = decltype(bizwen::segments(std::declval<range::const_iterator>(), std::declval<range::const_iterator>()));
+
+static_assert(std::same_as<segments, segments_sub>);
+static_assert(std::same_as<csegments, csegments_sub>);
+
+static_assert(std::same_as<std::ranges::range_value_t<segments>, std::span<int>>);
+static_assert(std::ranges::forward_range<segments>);
+static_assert(std::ranges::sized_range<segments>);
+static_assert(std::ranges::view<segments>);
+static_assert(std::ranges::contiguous_range<std::ranges::range_reference_t<segments>>);
+static_assert(std::ranges::sized_range<std::ranges::range_reference_t<segments>>);
+static_assert(std::ranges::forward_range<segments const>);
+static_assert(std::ranges::sized_range<segments const>);
+
+static_assert(std::same_as<std::ranges::range_value_t<csegments>, std::span<int const>>);
+static_assert(std::ranges::forward_range<csegments>);
+static_assert(std::ranges::sized_range<csegments>);
+static_assert(std::ranges::view<csegments>);
+static_assert(std::ranges::contiguous_range<std::ranges::range_reference_t<csegments>>);
+static_assert(std::ranges::sized_range<std::ranges::range_reference_t<csegments>>);
+
+static_assert(std::convertible_to<std::ranges::range_value_t<segments>, std::ranges::range_value_t<csegments>>);
+
+static_assert(std::same_as<decltype(std::declval<range::iterator>().local()), int*>);
+static_assert(std::same_as<decltype(std::declval<range::const_iterator>().local()), int const*>);
+static_assert(std::equality_comparable<decltype(std::declval<range::iterator>().segment())>);
+static_assert(std::random_access_iterator<decltype(std::declval<range::iterator>().segment())>);
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// iterator erase(const_iterator position);
+// void shrink_to_fit();
+
+//  As for deque, an erasure in the middle invalidates every iterator and
+//  reference. Inline elements stay inside the object, and elements on the
+//  heap stay on the heap however few of them are left, until shrink_to_fit()
+//  moves them back inline.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "test_macros.h"
+
+// Whether p points into the object c itself.
+template <class C>
+bool inside(const C& c, const typename C::value_type* p) {
+  const char* first = reinterpret_cast<const char*>(&c);
+  const char* q     = reinterpret_cast<const char*>(p);
+  return q >= first && q < first + sizeof(C);
+}
+
+template <class C>
+void check(const C& c, const std::vector<int>& model, bool is_inline) {
+  assert(c.is_inline() == is_inline);
+  assert(c.size() == model.size());
+  for (std::size_t j = 0; j < c.size(); ++j) {
+    assert(c[j] == model[j]);
+    assert(inside(c, &c[j]) == is_inline);
+  }
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+template <class C>
+void test(int size) {
+  const int n = static_cast<int>(C::inline_capacity());
+  C c;
+  std::vector<int> model;
+  for (int i = 0; i < size; ++i) {
+    c.push_back(i);
+    model.push_back(i);
+  }
+  const bool is_inline = size <= n;
+  check(c, model, is_inline);
+  while (c.size() > 1) {
+    const int pos           = static_cast<int>(c.size()) / 2;
+    typename C::iterator it = c.erase(c.begin() + pos);
+    model.erase(model.begin() + pos);
+    assert(it == c.begin() + pos);
+    check(c, model, is_inline);
+  }
+  c.shrink_to_fit();
+  check(c, model, true);
+  c.erase(c.begin());
+  model.erase(model.begin());
+  check(c, model, true);
+}
+
+int main(int, char**) {
+  test<bizwen::small_deque<int, 1> >(1);
+  test<bizwen::small_deque<int, 1> >(10);
+  test<bizwen::small_deque<int, 8> >(2);
+  test<bizwen::small_deque<int, 8> >(8);
+  test<bizwen::small_deque<int, 8> >(9);
+  test<bizwen::small_deque<int, 8> >(100);
+  test<bizwen::small_deque<int, 16> >(2000);
+
+  return 0;
+}
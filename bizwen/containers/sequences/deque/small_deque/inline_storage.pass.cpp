@@ -0,0 +1,185 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// template <class T, size_t N, class Allocator = allocator<T>>
+// class small_deque;
+//
+// static constexpr size_type inline_capacity() noexcept;
+// bool is_inline() const noexcept;
+
+//  small_deque has the interface of deque. Up to N elements are kept inside
+//  the object itself, so a small_deque that never holds more than N elements
+//  never allocates. The insertion that would exceed N moves the elements to
+//  heap blocks, where they stay until shrink_to_fit() finds that they fit
+//  inline again. Moving a small_deque whose elements are inline moves them one
+//  by one; heap storage is handed over as it is for deque.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "test_macros.h"
+#include "count_new.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+
+template <class C, class Model>
+void check(const C& c, const Model& model) {
+  assert(c.size() == model.size());
+  assert(c.empty() == model.empty());
+  for (std::size_t i = 0; i < model.size(); ++i)
+    assert(c[i] == model[i]);
+  assert(static_cast<std::size_t>(c.end() - c.begin()) == model.size());
+  std::size_t i = 0;
+  for (typename C::const_iterator it = c.begin(); it != c.end(); ++it, ++i)
+    assert(*it == model[i]);
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+// Fills and drains the inline storage from both ends, so that the elements
+// wrap around it, without allocating. The model is a vector with enough
+// capacity, so that it does not allocate either.
+template <class C>
+void test_inline() {
+  const int n = static_cast<int>(C::inline_capacity());
+  std::vector<int> model;
+  model.reserve(n + 1);
+  DisableAllocationGuard g;
+  C c;
+  assert(c.is_inline());
+  check(c, model);
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < n; ++i) {
+      if ((i + round) % 2 == 0) {
+        c.push_back(i);
+        model.push_back(i);
+      } else {
+        c.emplace_front(-i);
+        model.insert(model.begin(), -i);
+      }
+      check(c, model);
+    }
+    for (int i = 0; i < n / 2; ++i) {
+      c.pop_front();
+      model.erase(model.begin());
+      c.push_back(100 + i);
+      model.push_back(100 + i);
+      check(c, model);
+    }
+    while (!model.empty()) {
+      c.pop_back();
+      model.pop_back();
+      check(c, model);
+    }
+    assert(c.is_inline());
+  }
+}
+
+template <class C>
+void test_overflow() {
+  const int n = static_cast<int>(C::inline_capacity());
+  std::vector<int> model;
+  model.reserve(4 * n + 2);
+  const int outstanding = globalMemCounter.outstanding_new;
+  {
+    C c;
+    for (int i = 0; i < n; ++i) {
+      c.push_back(i);
+      model.push_back(i);
+    }
+    assert(c.is_inline());
+    assert(globalMemCounter.checkOutstandingNewEq(outstanding + 0));
+
+    // One more element than fits inline.
+    c.push_front(-1);
+    model.insert(model.begin(), -1);
+    assert(!c.is_inline());
+    check(c, model);
+    for (int i = 0; i < 3 * n; ++i) {
+      c.push_back(n + i);
+      model.push_back(n + i);
+    }
+    check(c, model);
+
+    // The elements stay on the heap until shrink_to_fit.
+    while (model.size() > static_cast<std::size_t>(n)) {
+      c.pop_front();
+      model.erase(model.begin());
+    }
+    assert(!c.is_inline());
+    check(c, model);
+    c.shrink_to_fit();
+    assert(c.is_inline());
+    check(c, model);
+    assert(globalMemCounter.checkOutstandingNewEq(outstanding + 0));
+
+    // Middle insertions and erasures cross the boundary both ways.
+    c.insert(c.begin() + n / 2, 7);
+    model.insert(model.begin() + n / 2, 7);
+    assert(!c.is_inline());
+    check(c, model);
+    c.erase(c.begin() + n / 2);
+    model.erase(model.begin() + n / 2);
+    check(c, model);
+  }
+  assert(globalMemCounter.checkOutstandingNewEq(outstanding + 0));
+}
+
+template <class C>
+void test_move() {
+  const int n = static_cast<int>(C::inline_capacity());
+  {
+    C c;
+    for (int i = 0; i < n; ++i)
+      c.push_back(i);
+    C d(std::move(c));
+    assert(d.is_inline());
+    assert(static_cast<int>(d.size()) == n);
+    for (int i = 0; i < n; ++i)
+      assert(d[i] == i);
+  }
+  {
+    C c;
+    for (int i = 0; i < 2 * n + 1; ++i)
+      c.push_back(i);
+    const typename C::value_type* first = &c[0];
+    C d(std::move(c));
+    assert(!d.is_inline());
+    assert(&d[0] == first);
+    assert(static_cast<int>(d.size()) == 2 * n + 1);
+    for (int i = 0; i < 2 * n + 1; ++i)
+      assert(d[i] == i);
+  }
+}
+
+template <class C>
+void test() {
+  static_assert(noexcept(C::inline_capacity()), "");
+  ASSERT_NOEXCEPT(std::declval<const C&>().is_inline());
+  test_inline<C>();
+  test_overflow<C>();
+  test_move<C>();
+}
+
+int main(int, char**) {
+  static_assert(bizwen::small_deque<int, 8>::inline_capacity() == 8, "");
+  test<bizwen::small_deque<int, 1> >();
+  test<bizwen::small_deque<int, 8> >();
+  test<bizwen::small_deque<int, 16> >();
+  test<bizwen::small_deque<block_int<4>, 8> >();
+#if TEST_STD_VER >= 11
+  test<bizwen::small_deque<int, 8, min_allocator<int> > >();
+#endif
+
+  return 0;
+}
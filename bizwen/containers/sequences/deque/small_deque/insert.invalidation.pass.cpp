@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// iterator insert(const_iterator position, const value_type& x);
+
+//  As for deque, an insertion in the middle invalidates every iterator and
+//  reference. While the elements fit inline they stay inside the object; the
+//  insertion that does not fit moves all of them to the heap, and they stay
+//  there for the insertions that follow.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "test_macros.h"
+
+// Whether p points into the object c itself.
+template <class C>
+bool inside(const C& c, const typename C::value_type* p) {
+  const char* first = reinterpret_cast<const char*>(&c);
+  const char* q     = reinterpret_cast<const char*>(p);
+  return q >= first && q < first + sizeof(C);
+}
+
+template <class C>
+void test(int size, int inserts) {
+  const int n = static_cast<int>(C::inline_capacity());
+  C c;
+  std::vector<int> model;
+  for (int i = 0; i < size; ++i) {
+    c.push_back(i);
+    model.push_back(i);
+  }
+  for (int k = 0; k < inserts; ++k) {
+    const bool was_inline   = c.is_inline();
+    const bool overflows    = was_inline && static_cast<int>(c.size()) == n;
+    const int pos           = static_cast<int>(c.size()) / 2;
+    typename C::iterator it = c.insert(c.begin() + pos, 1000 + k);
+    model.insert(model.begin() + pos, 1000 + k);
+    assert(it == c.begin() + pos);
+    assert(*it == 1000 + k);
+    assert(c.is_inline() == (was_inline && !overflows));
+    assert(c.size() == model.size());
+    for (std::size_t j = 0; j < c.size(); ++j) {
+      assert(c[j] == model[j]);
+      assert(inside(c, &c[j]) == c.is_inline());
+    }
+    LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+  }
+}
+
+int main(int, char**) {
+  test<bizwen::small_deque<int, 1> >(0, 10);
+  test<bizwen::small_deque<int, 1> >(1, 10);
+  test<bizwen::small_deque<int, 8> >(0, 100);
+  test<bizwen::small_deque<int, 8> >(5, 100);
+  test<bizwen::small_deque<int, 8> >(8, 100);
+  test<bizwen::small_deque<int, 16> >(3, 2000);
+
+  return 0;
+}
@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// small_deque(small_deque&& c);
+// small_deque& operator=(small_deque&& c);
+
+//  Moving a small_deque whose elements are on the heap hands the heap storage
+//  over, so the references to its elements stay valid and refer to the
+//  elements of the new owner, as for deque. Inline elements are moved into
+//  the new owner one by one, which invalidates the references to them. Either
+//  way the moved-from small_deque is left empty, with inline storage.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "test_macros.h"
+
+// Whether p points into the object c itself.
+template <class C>
+bool inside(const C& c, const typename C::value_type* p) {
+  const char* first = reinterpret_cast<const char*>(&c);
+  const char* q     = reinterpret_cast<const char*>(p);
+  return q >= first && q < first + sizeof(C);
+}
+
+// A small_deque holding first, ..., first + size - 1, pushed at both ends.
+template <class C>
+C make(int size, int first) {
+  C c;
+  for (int i = size / 2; i < size; ++i)
+    c.push_back(first + i);
+  for (int i = size / 2; i-- > 0;)
+    c.push_front(first + i);
+  return c;
+}
+
+template <class C>
+std::vector<const typename C::value_type*> addresses(const C& c) {
+  std::vector<const typename C::value_type*> refs;
+  for (std::size_t j = 0; j < c.size(); ++j)
+    refs.push_back(&c[j]);
+  return refs;
+}
+
+// d holds what c held, whose elements were at refs, and c is empty.
+template <class C>
+void check_moved(const C& c, const C& d, int size, bool was_inline,
+                 const std::vector<const typename C::value_type*>& refs) {
+  assert(c.empty());
+  assert(c.is_inline());
+  assert(static_cast<int>(d.size()) == size);
+  assert(d.is_inline() == was_inline);
+  for (int j = 0; j < size; ++j) {
+    assert(d[j] == j);
+    if (was_inline)
+      assert(inside(d, &d[j]));
+    else
+      assert(&d[j] == refs[j]);
+  }
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(d));
+}
+
+template <class C>
+void test() {
+  const int n     = static_cast<int>(C::inline_capacity());
+  const int rng[] = {0, 1, n, n + 1, 3 * n + 1};
+  for (int size : rng) {
+    {
+      C c                  = make<C>(size, 0);
+      const bool is_inline = c.is_inline();
+      auto refs            = addresses(c);
+      C d(std::move(c));
+      check_moved(c, d, size, is_inline, refs);
+    }
+    for (int other : rng) {
+      C c                  = make<C>(size, 0);
+      C d                  = make<C>(other, 1000);
+      const bool is_inline = c.is_inline();
+      auto refs            = addresses(c);
+      d                    = std::move(c);
+      check_moved(c, d, size, is_inline, refs);
+    }
+  }
+}
+
+int main(int, char**) {
+  test<bizwen::small_deque<int, 1> >();
+  test<bizwen::small_deque<int, 8> >();
+  test<bizwen::small_deque<int, 16> >();
+
+  return 0;
+}
@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// void pop_front()
+
+//  Erasing items from the beginning or the end of a small_deque shall not
+//  invalidate iterators to items that were not erased, whether the items are
+//  stored inline or on the heap.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+
+#include "test_macros.h"
+
+template <typename C>
+void test(C& c) {
+  typename C::iterator it1 = c.begin() + 1;
+  typename C::iterator it2 = c.end() - 1;
+
+  c.pop_front();
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+
+  typename C::iterator it3 = c.begin();
+  typename C::iterator it4 = c.end() - 1;
+  assert(it1 == it3);
+  assert(*it1 == *it3);
+  assert(&*it1 == &*it3);
+  assert(it2 == it4);
+  assert(*it2 == *it4);
+  assert(&*it2 == &*it4);
+}
+
+template <typename C>
+void test(int size) {
+  C queue;
+  for (int i = 0; i < size; ++i)
+    queue.push_back(i);
+
+  while (queue.size() > 1)
+    test(queue);
+}
+
+int main(int, char**) {
+  test<bizwen::small_deque<int, 8> >(8);
+  test<bizwen::small_deque<int, 8> >(4098);
+  test<bizwen::small_deque<int, 16> >(16);
+  test<bizwen::small_deque<int, 16> >(4098);
+
+  return 0;
+}
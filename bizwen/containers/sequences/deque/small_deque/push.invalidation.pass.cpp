@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// void push_back(const value_type& x);
+// void push_front(const value_type& x);
+
+//  As for deque, an insertion at either end invalidates the iterators but not
+//  the references to the elements. The one exception is the insertion that
+//  does not fit inline any more, which moves every element to the heap.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "test_macros.h"
+
+template <class C>
+void test(int pushes) {
+  typedef typename C::value_type T;
+  const int n = static_cast<int>(C::inline_capacity());
+  C c;
+  std::vector<const T*> refs;
+  for (int i = 0; i < pushes; ++i) {
+    const bool overflows = c.is_inline() && static_cast<int>(c.size()) == n;
+    if (i % 3 == 0) {
+      c.push_front(-i);
+      refs.insert(refs.begin(), &c.front());
+    } else {
+      c.push_back(i);
+      refs.push_back(&c.back());
+    }
+    if (overflows) {
+      assert(!c.is_inline());
+      for (std::size_t j = 0; j < c.size(); ++j)
+        refs[j] = &c[j];
+      continue;
+    }
+    assert(refs.size() == c.size());
+    for (std::size_t j = 0; j < c.size(); ++j)
+      assert(refs[j] == &c[j]);
+    LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+  }
+}
+
+int main(int, char**) {
+  test<bizwen::small_deque<int, 1> >(50);
+  test<bizwen::small_deque<int, 8> >(5000);
+  test<bizwen::small_deque<int, 16> >(5000);
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// void swap(small_deque& c);
+// void swap(small_deque& x, small_deque& y);
+
+//  Swapping hands heap storage over, so the references to elements on the
+//  heap stay valid and refer to the same elements, now in the other
+//  small_deque, as for deque. Inline elements are moved into the other object
+//  one by one, which invalidates the references to them.
+
+#include "asan_testing.h"
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "test_macros.h"
+
+// Whether p points into the object c itself.
+template <class C>
+bool inside(const C& c, const typename C::value_type* p) {
+  const char* first = reinterpret_cast<const char*>(&c);
+  const char* q     = reinterpret_cast<const char*>(p);
+  return q >= first && q < first + sizeof(C);
+}
+
+// A small_deque holding first, ..., first + size - 1, pushed at both ends.
+template <class C>
+C make(int size, int first) {
+  C c;
+  for (int i = size / 2; i < size; ++i)
+    c.push_back(first + i);
+  for (int i = size / 2; i-- > 0;)
+    c.push_front(first + i);
+  return c;
+}
+
+template <class C>
+std::vector<const typename C::value_type*> addresses(const C& c) {
+  std::vector<const typename C::value_type*> refs;
+  for (std::size_t j = 0; j < c.size(); ++j)
+    refs.push_back(&c[j]);
+  return refs;
+}
+
+// c holds first, ..., first + size - 1, which were at refs in a small_deque
+// whose storage was inline if was_inline.
+template <class C>
+void check(const C& c, int size, int first, bool was_inline, const std::vector<const typename C::value_type*>& refs) {
+  assert(static_cast<int>(c.size()) == size);
+  assert(c.is_inline() == was_inline);
+  for (int j = 0; j < size; ++j) {
+    assert(c[j] == first + j);
+    if (was_inline)
+      assert(inside(c, &c[j]));
+    else
+      assert(&c[j] == refs[j]);
+  }
+  LIBCPP_ASSERT(is_double_ended_contiguous_container_asan_correct(c));
+}
+
+template <class C>
+void test() {
+  const int n     = static_cast<int>(C::inline_capacity());
+  const int rng[] = {0, 1, n, n + 1, 3 * n + 1};
+  for (int x : rng) {
+    for (int y : rng) {
+      C c                 = make<C>(x, 0);
+      C d                 = make<C>(y, 1000);
+      const bool c_inline = c.is_inline();
+      const bool d_inline = d.is_inline();
+      auto c_refs         = addresses(c);
+      auto d_refs         = addresses(d);
+      c.swap(d);
+      check(c, y, 1000, d_inline, d_refs);
+      check(d, x, 0, c_inline, c_refs);
+      c_refs = addresses(c);
+      d_refs = addresses(d);
+      swap(c, d);
+      check(c, x, 0, c_inline, d_refs);
+      check(d, y, 1000, d_inline, c_refs);
+    }
+  }
+}
+
+int main(int, char**) {
+  test<bizwen::small_deque<int, 1> >();
+  test<bizwen::small_deque<int, 8> >();
+  test<bizwen::small_deque<int, 16> >();
+
+  return 0;
+}
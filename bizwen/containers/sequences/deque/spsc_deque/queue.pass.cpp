@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// "deque.hpp"
+
+// template <class T, class Allocator = allocator<T>>
+// class spsc_deque {
+// public:
+//   spsc_deque();
+//   explicit spsc_deque(const Allocator& a);
+//
+//   // producer
+//   void push_back(const T& x);
+//   void push_back(T&& x);
+//   template <class... Args> void emplace_back(Args&&... args);
+//
+//   // consumer
+//   bool try_pop_front(T& x);
+//   optional<T> try_pop_front();
+//
+//   // either thread
+//   bool empty() const noexcept;
+//   size_type size() const noexcept;
+// };
+
+//  A queue for one producer thread and one consumer thread, laid out in
+//  blocks of deque_block_traits<T>::block_elements like deque. The producer
+//  publishes its tail with a release store and the consumer its head, so
+//  neither takes a lock. Blocks emptied by the consumer go back to the
+//  producer through a lock-free free list holding up to max_spare_blocks of
+//  them, so a queue that does not grow stops allocating. The elements left
+//  in the queue are destroyed with it.
+
+#include "deque.hpp"
+#include <cassert>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "test_macros.h"
+#include "MoveOnly.h"
+#include "count_new.h"
+#include "deque_block_size.h"
+#include "min_allocator.h"
+
+// Counts its live instances.
+struct Counted {
+  static int live;
+  int value;
+
+  Counted(int v = 0) : value(v) { ++live; }
+  Counted(const Counted& other) : value(other.value) { ++live; }
+  Counted& operator=(const Counted&) = default;
+  ~Counted() { --live; }
+};
+
+int Counted::live = 0;
+
+static_assert(!std::is_copy_constructible<bizwen::spsc_deque<int> >::value, "");
+static_assert(!std::is_move_constructible<bizwen::spsc_deque<int> >::value, "");
+
+// Elements come out in the order they went in, across many blocks and with
+// the queue emptied at various points.
+template <class Q>
+void test_fifo(int N) {
+  typedef typename Q::value_type T;
+  Q q;
+  assert(q.empty());
+  assert(q.size() == 0);
+  T x(-1);
+  assert(!q.try_pop_front(x));
+  assert(x == T(-1));
+  assert(!q.try_pop_front().has_value());
+
+  int next_in  = 0;
+  int next_out = 0;
+  for (int round = 1; next_in < N; ++round) {
+    for (int i = 0; i < round * 7 && next_in < N; ++i)
+      q.push_back(T(next_in++));
+    assert(static_cast<int>(q.size()) == next_in - next_out);
+    for (int i = 0; i < round * 5 && next_out < next_in; ++i) {
+      assert(q.try_pop_front(x));
+      assert(x == T(next_out++));
+    }
+  }
+  while (next_out < N) {
+    std::optional<T> y = q.try_pop_front();
+    assert(y.has_value());
+    assert(*y == T(next_out++));
+  }
+  assert(q.empty());
+  assert(!q.try_pop_front(x));
+}
+
+// A queue that holds a bounded number of elements allocates nothing once its
+// blocks have been through the free list.
+template <class Q>
+void test_recycling(int window) {
+  typedef typename Q::value_type T;
+  const int b = static_cast<int>(bizwen::deque_block_traits<T>::block_elements);
+  Q q;
+  T x;
+  int next = 0;
+  for (int i = 0; i < window; ++i)
+    q.push_back(T(next++));
+  for (int i = 0; i < 4 * b; ++i) {
+    q.push_back(T(next++));
+    assert(q.try_pop_front(x));
+  }
+  globalMemCounter.reset();
+  for (int i = 0; i < 64 * b; ++i) {
+    q.push_back(T(next++));
+    assert(q.try_pop_front(x));
+    assert(x == T(next - window - 1));
+  }
+  assert(globalMemCounter.checkNewCalledEq(0));
+  assert(static_cast<int>(q.size()) == window);
+}
+
+int main(int, char**) {
+  int rng[] = {0, 1, 2, 3, 15, 16, 17, 1023, 1024, 1025, 2049, 100000};
+  for (int N : rng) {
+    test_fifo<bizwen::spsc_deque<int> >(N);
+    test_fifo<bizwen::spsc_deque<block_int<1> > >(N);
+    test_fifo<bizwen::spsc_deque<block_int<16> > >(N);
+#if TEST_STD_VER >= 11
+    test_fifo<bizwen::spsc_deque<int, min_allocator<int> > >(N);
+#endif
+  }
+
+  int windows[] = {0, 1, 15, 16, 17, 40};
+  for (int w : windows) {
+    test_recycling<bizwen::spsc_deque<block_int<16> > >(w);
+    test_recycling<bizwen::spsc_deque<int> >(w);
+  }
+
+  {
+    bizwen::spsc_deque<MoveOnly> q;
+    q.push_back(MoveOnly(1));
+    q.emplace_back(2);
+    MoveOnly m;
+    assert(q.try_pop_front(m));
+    assert(m == MoveOnly(1));
+    std::optional<MoveOnly> o = q.try_pop_front();
+    assert(o && *o == MoveOnly(2));
+  }
+
+  // The elements still queued are destroyed with the queue.
+  {
+    bizwen::spsc_deque<Counted> q;
+    for (int i = 0; i < 3000; ++i)
+      q.emplace_back(i);
+    Counted c;
+    for (int i = 0; i < 1000; ++i)
+      assert(q.try_pop_front(c));
+    assert(Counted::live == 2001);
+  }
+  assert(Counted::live == 0);
+
+  return 0;
+}
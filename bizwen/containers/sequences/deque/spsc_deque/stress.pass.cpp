@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// UNSUPPORTED: no-threads
+
+// "deque.hpp"
+
+// template <class T, class Allocator = allocator<T>>
+// class spsc_deque;
+
+//  One thread pushes while another pops. Every element arrives once, in
+//  order and fully constructed, whether the consumer is waiting on an empty
+//  queue or lagging many blocks behind the producer.
+
+#include "deque.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <thread>
+
+#include "test_macros.h"
+#include "deque_block_size.h"
+#include "make_test_thread.h"
+
+// A value whose contents live on the heap, so that reading it before it has
+// been published reads memory that is not initialized yet.
+struct Boxed {
+  std::string text;
+
+  Boxed(int v = 0) : text(std::to_string(v) + " is a value long enough not to fit inline") {}
+
+  friend bool operator==(const Boxed& x, const Boxed& y) { return x.text == y.text; }
+};
+
+namespace bizwen {
+template <>
+struct deque_block_traits<Boxed> {
+  static constexpr std::size_t block_elements = 8;
+};
+} // namespace bizwen
+
+// The producer pushes N elements in bursts of burst, yielding between them;
+// the consumer pops them as they come.
+template <class T>
+void test(int N, int burst) {
+  bizwen::spsc_deque<T> q;
+  std::atomic<bool> done(false);
+
+  std::thread producer = support::make_test_thread([&] {
+    for (int i = 0; i < N; ++i) {
+      q.push_back(T(i));
+      if (burst != 0 && i % burst == 0)
+        std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  T x;
+  int next = 0;
+  while (next < N) {
+    if (q.try_pop_front(x)) {
+      assert(x == T(next));
+      ++next;
+    } else {
+      std::this_thread::yield();
+    }
+    assert(q.size() <= static_cast<std::size_t>(N - next));
+  }
+  producer.join();
+  assert(done.load());
+  assert(q.empty());
+  assert(!q.try_pop_front(x));
+}
+
+// The consumer only starts once the producer has pushed N / 2 elements, so
+// that it walks a long chain of blocks while the producer, still pushing the
+// other half, reuses the blocks that the consumer frees.
+template <class T>
+void test_lagging(int N) {
+  bizwen::spsc_deque<T> q;
+  std::atomic<int> pushed(0);
+
+  std::thread producer = support::make_test_thread([&] {
+    for (int i = 0; i < N; ++i) {
+      q.push_back(T(i));
+      pushed.store(i + 1, std::memory_order_release);
+    }
+  });
+
+  while (pushed.load(std::memory_order_acquire) < N / 2)
+    std::this_thread::yield();
+  T x;
+  for (int next = 0; next < N;) {
+    if (q.try_pop_front(x)) {
+      assert(x == T(next));
+      ++next;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  assert(q.empty());
+}
+
+int main(int, char**) {
+  test<int>(1 << 20, 0);
+  test<int>(1 << 18, 64);
+  test<block_int<1> >(1 << 18, 0);
+  test<block_int<16> >(1 << 18, 7);
+  test<Boxed>(1 << 16, 0);
+  test<Boxed>(1 << 16, 5);
+
+  test_lagging<block_int<16> >(1 << 18);
+  test_lagging<Boxed>(1 << 15);
+
+  return 0;
+}
@@ -0,0 +1,3134 @@
+#ifndef BIZWEN_DEQUE_HPP
+#define BIZWEN_DEQUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// AddressSanitizer builds poison the slots of every block that hold no element.
+// As in libc++, the sanitizer is detected with __has_feature, which compilers
+// whose runtime lacks the double-ended container interface do not provide;
+// defining BIZWEN_DEQUE_ASAN to 0 or 1 overrides the detection.
+#ifndef BIZWEN_DEQUE_ASAN
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define BIZWEN_DEQUE_ASAN 1
+#endif
+#endif
+#endif
+#ifndef BIZWEN_DEQUE_ASAN
+#define BIZWEN_DEQUE_ASAN 0
+#endif
+
+#if BIZWEN_DEQUE_ASAN
+extern "C" void __sanitizer_annotate_double_ended_contiguous_container(const void *storage_beg,
+                                                                      const void *storage_end,
+                                                                      const void *old_container_beg,
+                                                                      const void *old_container_end,
+                                                                      const void *new_container_beg,
+                                                                      const void *new_container_end);
+extern "C" int __sanitizer_verify_double_ended_contiguous_container(const void *storage_beg,
+                                                                   const void *container_beg,
+                                                                   const void *container_end,
+                                                                   const void *storage_end);
+#endif
+
+namespace bizwen
+{
+
+namespace detail
+{
+
+inline constexpr std::size_t default_max_spare_blocks = 4;
+
+} // namespace detail
+
+// Sets how the blocks of a deque<T> are laid out. A specialization must give
+// block_elements, a power of two, and may give max_spare_blocks, the number of
+// empty blocks a deque keeps for reuse instead of deallocating them, and
+// min_block_elements, a smaller power of two: the first block a deque
+// allocates then holds min_block_elements and each block further from it holds
+// twice as many as its neighbour, up to block_elements.
+template <class T>
+struct deque_block_traits
+{
+    // The largest power of two whose block fits in 4096 bytes, or 1 for larger elements.
+    static constexpr std::size_t block_elements = sizeof(T) < 4096 ? std::bit_floor(4096 / sizeof(T)) : 1;
+    static constexpr std::size_t max_spare_blocks = detail::default_max_spare_blocks;
+};
+
+// Whether moving the bytes of a T to another address, and forgetting the
+// original, is equivalent to move-constructing a new T there and destroying
+// the original. Specialize it for types such as std::unique_ptr to let insert
+// and erase in the middle shift them with memmove.
+template <class T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T>
+{
+};
+
+template <class T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+namespace detail
+{
+
+template <class T>
+inline constexpr std::size_t block_elements_v = deque_block_traits<T>::block_elements;
+
+template <class T>
+consteval std::size_t max_spare_blocks_of()
+{
+    if constexpr (requires { deque_block_traits<T>::max_spare_blocks; })
+        return deque_block_traits<T>::max_spare_blocks;
+    else
+        return default_max_spare_blocks;
+}
+
+template <class T>
+inline constexpr std::size_t max_spare_blocks_v = max_spare_blocks_of<T>();
+
+template <class T>
+consteval std::size_t min_block_elements_of()
+{
+    if constexpr (requires { deque_block_traits<T>::min_block_elements; })
+        return deque_block_traits<T>::min_block_elements;
+    else
+        return deque_block_traits<T>::block_elements;
+}
+
+template <class T>
+inline constexpr std::size_t min_block_elements_v = min_block_elements_of<T>();
+
+// Maps the position of an element, counted from the start of block 0, to its
+// block and back. Blocks are numbered from 0 towards the back and from -1
+// towards the front. Every block holds max_elements, unless min_elements is
+// smaller: blocks 0 and -1 then hold min_elements, and each block further out
+// twice as many as its neighbour, up to max_elements. ramp_blocks is the
+// number of such smaller blocks on each side, and ramp the elements they hold.
+template <class T>
+struct block_layout
+{
+    static constexpr std::size_t max_elements = block_elements_v<T>;
+    static constexpr std::size_t min_elements = min_block_elements_v<T>;
+
+    static_assert(std::has_single_bit(max_elements), "deque_block_traits<T>::block_elements must be a power of two");
+    static_assert(std::has_single_bit(min_elements) && min_elements <= max_elements,
+                  "deque_block_traits<T>::min_block_elements must be a power of two no larger than block_elements");
+
+    static constexpr int shift = std::countr_zero(max_elements);
+    static constexpr int min_shift = std::countr_zero(min_elements);
+    static constexpr std::ptrdiff_t ramp_blocks = shift - min_shift;
+    static constexpr std::ptrdiff_t ramp = static_cast<std::ptrdiff_t>(max_elements - min_elements);
+    static constexpr std::ptrdiff_t mask = static_cast<std::ptrdiff_t>(max_elements - 1);
+
+    static constexpr std::ptrdiff_t block_of(std::ptrdiff_t s) noexcept
+    {
+        if constexpr (ramp_blocks == 0)
+            return s >> shift;
+        else
+            return s >= 0 ? rank(s) : -rank(-s - 1) - 1;
+    }
+
+    static constexpr std::ptrdiff_t start(std::ptrdiff_t j) noexcept
+    {
+        if constexpr (ramp_blocks == 0)
+            return j * static_cast<std::ptrdiff_t>(max_elements);
+        else
+            return j >= 0 ? offset(j) : -offset(-j);
+    }
+
+    static constexpr std::ptrdiff_t size(std::ptrdiff_t j) noexcept
+    {
+        if constexpr (ramp_blocks == 0)
+        {
+            return static_cast<std::ptrdiff_t>(max_elements);
+        }
+        else
+        {
+            auto const k = j >= 0 ? j : -j - 1;
+            return k < ramp_blocks ? static_cast<std::ptrdiff_t>(min_elements) << k
+                                   : static_cast<std::ptrdiff_t>(max_elements);
+        }
+    }
+
+  private:
+    // The block, counted from 0, holding the t-th element on one side.
+    static constexpr std::ptrdiff_t rank(std::ptrdiff_t t) noexcept
+    {
+        if (t >= ramp)
+            return ramp_blocks + ((t - ramp) >> shift);
+        return std::bit_width(static_cast<std::size_t>((t >> min_shift) + 1)) - 1;
+    }
+
+    // The elements held by the first k blocks on one side.
+    static constexpr std::ptrdiff_t offset(std::ptrdiff_t k) noexcept
+    {
+        if (k <= ramp_blocks)
+            return ((std::ptrdiff_t{1} << k) - 1) << min_shift;
+        return ramp + ((k - ramp_blocks) << shift);
+    }
+};
+
+struct deque_iterator_access;
+
+template <class Alloc, class T>
+concept has_construct = requires(Alloc &a, T *p, T const &v) { a.construct(p, v); };
+
+#if BIZWEN_DEQUE_ASAN
+inline void annotate_block(void const *first, void const *last, void const *old_first, void const *old_last,
+                           void const *new_first, void const *new_last) noexcept
+{
+    __sanitizer_annotate_double_ended_contiguous_container(first, last, old_first, old_last, new_first, new_last);
+}
+#endif
+
+} // namespace detail
+
+template <class Span, class Iterator>
+class segment_view;
+
+// A deque iterator is two words: the map slot of block 0 and the position of
+// its element counted from the start of that block. Moving, comparing and
+// subtracting iterators only touches the position; dereferencing finds the
+// block with a shift and the element with a mask.
+template <class T, bool Const, class Difference = std::ptrdiff_t>
+class deque_iterator
+{
+    template <class, class>
+    friend class deque;
+    template <class, bool, class>
+    friend class deque_iterator;
+    template <class, class>
+    friend class segment_view;
+    friend struct detail::deque_iterator_access;
+
+    using layout = detail::block_layout<T>;
+
+    T *const *origin_ = nullptr;
+    std::ptrdiff_t pos_ = 0;
+
+    constexpr deque_iterator(T *const *origin, std::ptrdiff_t pos) noexcept : origin_(origin), pos_(pos)
+    {
+    }
+
+    // The position of the element counted from the start of block 0.
+    constexpr std::ptrdiff_t position() const noexcept
+    {
+        return pos_;
+    }
+
+  public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = Difference;
+    using pointer = std::conditional_t<Const, T const *, T *>;
+    using reference = std::conditional_t<Const, T const &, T &>;
+
+    constexpr deque_iterator() noexcept = default;
+
+    template <bool OtherConst>
+        requires(Const && !OtherConst)
+    constexpr deque_iterator(deque_iterator<T, OtherConst, Difference> const &other) noexcept
+        : origin_(other.origin_), pos_(other.pos_)
+    {
+    }
+
+    // The map slot of the block holding the element.
+    constexpr T *const *segment() const noexcept
+    {
+        return origin_ + layout::block_of(pos_);
+    }
+
+    // The address of the element.
+    constexpr pointer local() const noexcept
+    {
+        auto const j = layout::block_of(pos_);
+        return origin_[j] + (pos_ - layout::start(j));
+    }
+
+    constexpr reference operator*() const noexcept
+    {
+        return *local();
+    }
+
+    constexpr pointer operator->() const noexcept
+    {
+        return local();
+    }
+
+    constexpr reference operator[](difference_type n) const noexcept
+    {
+        return *(*this + n);
+    }
+
+    constexpr deque_iterator &operator++() noexcept
+    {
+        ++pos_;
+        return *this;
+    }
+
+    constexpr deque_iterator operator++(int) noexcept
+    {
+        auto tmp = *this;
+        ++pos_;
+        return tmp;
+    }
+
+    constexpr deque_iterator &operator--() noexcept
+    {
+        --pos_;
+        return *this;
+    }
+
+    constexpr deque_iterator operator--(int) noexcept
+    {
+        auto tmp = *this;
+        --pos_;
+        return tmp;
+    }
+
+    constexpr deque_iterator &operator+=(difference_type n) noexcept
+    {
+        pos_ += n;
+        return *this;
+    }
+
+    constexpr deque_iterator &operator-=(difference_type n) noexcept
+    {
+        pos_ -= n;
+        return *this;
+    }
+
+    friend constexpr deque_iterator operator+(deque_iterator it, difference_type n) noexcept
+    {
+        it.pos_ += n;
+        return it;
+    }
+
+    friend constexpr deque_iterator operator+(difference_type n, deque_iterator it) noexcept
+    {
+        it.pos_ += n;
+        return it;
+    }
+
+    friend constexpr deque_iterator operator-(deque_iterator it, difference_type n) noexcept
+    {
+        it.pos_ -= n;
+        return it;
+    }
+
+    // An iterator converts to a const_iterator, so these also compare and
+    // subtract the two kinds with each other.
+    friend constexpr difference_type operator-(deque_iterator const &lhs, deque_iterator const &rhs) noexcept
+    {
+        return static_cast<difference_type>(lhs.pos_ - rhs.pos_);
+    }
+
+    friend constexpr bool operator==(deque_iterator const &lhs, deque_iterator const &rhs) noexcept
+    {
+        return lhs.pos_ == rhs.pos_;
+    }
+
+    friend constexpr std::strong_ordering operator<=>(deque_iterator const &lhs, deque_iterator const &rhs) noexcept
+    {
+        return lhs.pos_ <=> rhs.pos_;
+    }
+};
+
+namespace detail
+{
+
+template <class I>
+inline constexpr bool is_deque_iterator_v = false;
+
+template <class T, bool Const, class Difference>
+inline constexpr bool is_deque_iterator_v<deque_iterator<T, Const, Difference>> = true;
+
+template <class I>
+concept deque_iterator_type = is_deque_iterator_v<I>;
+
+// What the segmented algorithms need to know about a deque iterator beyond
+// its public interface.
+struct deque_iterator_access
+{
+    // The elements from it to the end of its block, or to last if that is
+    // nearer.
+    template <class I>
+    static constexpr std::ptrdiff_t run_after(I const &it, I const &last) noexcept
+    {
+        using layout = typename I::layout;
+        auto const end = layout::start(layout::block_of(it.position()) + 1);
+        return (end < last.position() ? end : last.position()) - it.position();
+    }
+
+    // The elements from the start of the block of the element before it up
+    // to it, or from first if that is nearer.
+    template <class I>
+    static constexpr std::ptrdiff_t run_before(I const &first, I const &it) noexcept
+    {
+        using layout = typename I::layout;
+        auto const begin = layout::start(layout::block_of(it.position() - 1));
+        return it.position() - (begin > first.position() ? begin : first.position());
+    }
+
+    // The first element of the k-th block after the one holding it.
+    template <class I>
+    static constexpr I block_begin(I const &it, std::ptrdiff_t k) noexcept
+    {
+        using layout = typename I::layout;
+        return I(it.origin_, layout::start(layout::block_of(it.position()) + k));
+    }
+
+    // How many blocks after the block of first the block of last is.
+    template <class I>
+    static constexpr std::ptrdiff_t block_distance(I const &first, I const &last) noexcept
+    {
+        using layout = typename I::layout;
+        return layout::block_of(last.position()) - layout::block_of(first.position());
+    }
+};
+
+struct deque_access;
+
+} // namespace detail
+
+// The contiguous pieces of [first, last), one per block it touches, as
+// std::span<T> or std::span<T const>.
+template <class Span, class Iterator>
+class segment_view : public std::ranges::view_interface<segment_view<Span, Iterator>>
+{
+    Iterator first_{};
+    Iterator last_{};
+
+  public:
+    class iterator
+    {
+        Iterator cur_{};
+        Iterator last_{};
+
+      public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Span;
+        using difference_type = std::ptrdiff_t;
+
+        constexpr iterator() noexcept = default;
+
+        constexpr iterator(Iterator cur, Iterator last) noexcept : cur_(cur), last_(last)
+        {
+        }
+
+        constexpr Span operator*() const noexcept
+        {
+            return Span(cur_.local(), static_cast<std::size_t>(detail::deque_iterator_access::run_after(cur_, last_)));
+        }
+
+        constexpr iterator &operator++() noexcept
+        {
+            cur_ += detail::deque_iterator_access::run_after(cur_, last_);
+            return *this;
+        }
+
+        constexpr iterator operator++(int) noexcept
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(iterator const &lhs, iterator const &rhs) noexcept
+        {
+            return lhs.cur_ == rhs.cur_;
+        }
+    };
+
+    constexpr segment_view() noexcept = default;
+
+    constexpr segment_view(Iterator first, Iterator last) noexcept : first_(first), last_(last)
+    {
+    }
+
+    constexpr iterator begin() const noexcept
+    {
+        return iterator(first_, last_);
+    }
+
+    constexpr iterator end() const noexcept
+    {
+        return iterator(last_, last_);
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+        if (first_ == last_)
+            return 0;
+        using layout = typename Iterator::layout;
+        auto const blocks = layout::block_of(last_.position() - 1) - layout::block_of(first_.position()) + 1;
+        return static_cast<std::size_t>(blocks);
+    }
+};
+
+// The blocks of [first, last) as contiguous spans.
+template <class T, bool Const, class Difference>
+constexpr auto segments(deque_iterator<T, Const, Difference> first, deque_iterator<T, Const, Difference> last) noexcept
+{
+    using span = std::span<std::conditional_t<Const, T const, T>>;
+    return segment_view<span, deque_iterator<T, Const, Difference>>(first, last);
+}
+
+namespace detail
+{
+
+// A pointer to the element at it, for a deque iterator or a contiguous one.
+template <class I>
+constexpr auto raw_pointer(I const &it) noexcept
+{
+    if constexpr (is_deque_iterator_v<I>)
+        return it.local();
+    else
+        return std::to_address(it);
+}
+
+// How many elements from it onwards are contiguous, at most n.
+template <class I>
+constexpr std::ptrdiff_t contiguous_after(I const &it, std::ptrdiff_t n) noexcept
+{
+    if constexpr (is_deque_iterator_v<I>)
+        return deque_iterator_access::run_after(it, it + n);
+    else
+        return n;
+}
+
+// How many elements before it are contiguous, at most n.
+template <class I>
+constexpr std::ptrdiff_t contiguous_before(I const &it, std::ptrdiff_t n) noexcept
+{
+    if constexpr (is_deque_iterator_v<I>)
+        return deque_iterator_access::run_before(it - n, it);
+    else
+        return n;
+}
+
+template <class I, class O>
+concept segmentable =
+    (is_deque_iterator_v<I> || is_deque_iterator_v<O>) &&
+    (is_deque_iterator_v<I> || std::contiguous_iterator<I>) && (is_deque_iterator_v<O> || std::contiguous_iterator<O>);
+
+// Copies or moves [first, last) to out one pair of contiguous runs at a time,
+// with std::copy on raw pointers, which is memmove for trivially copyable
+// elements.
+template <bool Move, class I, class O>
+constexpr O copy_segments(I first, I last, O out)
+{
+    for (std::ptrdiff_t n = last - first; n != 0;)
+    {
+        auto const k = std::min(contiguous_after(first, n), contiguous_after(out, n));
+        auto const src = raw_pointer(first);
+        if constexpr (Move)
+            std::move(src, src + k, raw_pointer(out));
+        else
+            std::copy(src, src + k, raw_pointer(out));
+        first += k;
+        out += k;
+        n -= k;
+    }
+    return out;
+}
+
+template <bool Move, class I, class O>
+constexpr O copy_segments_backward(I first, I last, O out)
+{
+    for (std::ptrdiff_t n = last - first; n != 0;)
+    {
+        auto const k = std::min(contiguous_before(last, n), contiguous_before(out, n));
+        last -= k;
+        out -= k;
+        auto const src = raw_pointer(last);
+        if constexpr (Move)
+            std::move_backward(src, src + k, raw_pointer(out) + k);
+        else
+            std::copy_backward(src, src + k, raw_pointer(out) + k);
+        n -= k;
+    }
+    return out;
+}
+
+} // namespace detail
+
+// std::copy and friends for ranges that begin or end in a deque. Between a
+// deque and a deque or a contiguous range they go block by block over raw
+// pointers; otherwise they are the std algorithms.
+template <class I, class O>
+    requires(detail::is_deque_iterator_v<I> || detail::is_deque_iterator_v<O>)
+constexpr O copy(I first, I last, O out)
+{
+    if constexpr (detail::segmentable<I, O>)
+        return detail::copy_segments<false>(first, last, out);
+    else
+        return std::copy(first, last, out);
+}
+
+template <class I, class O>
+    requires(detail::is_deque_iterator_v<I> || detail::is_deque_iterator_v<O>)
+constexpr O move(I first, I last, O out)
+{
+    if constexpr (detail::segmentable<I, O>)
+        return detail::copy_segments<true>(first, last, out);
+    else
+        return std::move(first, last, out);
+}
+
+template <class I, class O>
+    requires(detail::is_deque_iterator_v<I> || detail::is_deque_iterator_v<O>)
+constexpr O copy_backward(I first, I last, O out)
+{
+    if constexpr (detail::segmentable<I, O>)
+        return detail::copy_segments_backward<false>(first, last, out);
+    else
+        return std::copy_backward(first, last, out);
+}
+
+template <class I, class O>
+    requires(detail::is_deque_iterator_v<I> || detail::is_deque_iterator_v<O>)
+constexpr O move_backward(I first, I last, O out)
+{
+    if constexpr (detail::segmentable<I, O>)
+        return detail::copy_segments_backward<true>(first, last, out);
+    else
+        return std::move_backward(first, last, out);
+}
+
+namespace detail
+{
+
+// An iterator the standard containers take as one: one whose category is
+// at least input_iterator_tag, which leaves out integers.
+template <class I>
+concept input_iterator =
+    std::derived_from<typename std::iterator_traits<I>::iterator_category, std::input_iterator_tag>;
+
+template <class R, class T>
+concept container_compatible_range =
+    std::ranges::input_range<R> && std::convertible_to<std::ranges::range_reference_t<R>, T>;
+
+// Elements that are equal exactly when their bytes are.
+template <class T>
+inline constexpr bool memcmp_equal_v = std::is_integral_v<T> || std::is_same_v<T, std::byte>;
+
+// Elements that are also ordered as their bytes are by memcmp.
+template <class T>
+inline constexpr bool memcmp_ordered_v = std::is_same_v<T, unsigned char> || std::is_same_v<T, std::byte> ||
+                                         std::is_same_v<T, bool> || std::is_same_v<T, char8_t> ||
+                                         (std::is_same_v<T, char> && std::is_unsigned_v<char>);
+
+struct synth_three_way
+{
+    template <class T, class U>
+    constexpr auto operator()(T const &t, U const &u) const
+        requires requires {
+            { t < u } -> std::convertible_to<bool>;
+            { u < t } -> std::convertible_to<bool>;
+        }
+    {
+        if constexpr (std::three_way_comparable_with<T, U>)
+        {
+            return t <=> u;
+        }
+        else
+        {
+            if (t < u)
+                return std::weak_ordering::less;
+            if (u < t)
+                return std::weak_ordering::greater;
+            return std::weak_ordering::equivalent;
+        }
+    }
+};
+
+// Compares two deque ranges of the same length a pair of contiguous runs at
+// a time, with memcmp where the bytes of the elements tell.
+template <class I>
+bool segments_equal(I first1, I last1, I first2)
+{
+    for (std::ptrdiff_t n = last1 - first1; n != 0;)
+    {
+        auto const k = std::min(contiguous_after(first1, n), contiguous_after(first2, n));
+        auto const p = raw_pointer(first1);
+        auto const q = raw_pointer(first2);
+        if constexpr (memcmp_equal_v<typename I::value_type>)
+        {
+            if (std::memcmp(p, q, static_cast<std::size_t>(k) * sizeof(*p)) != 0)
+                return false;
+        }
+        else
+        {
+            if (!std::equal(p, p + k, q))
+                return false;
+        }
+        first1 += k;
+        first2 += k;
+        n -= k;
+    }
+    return true;
+}
+
+template <class I>
+auto segments_compare(I first1, I last1, I first2, I last2)
+{
+    using T = typename I::value_type;
+    using result = decltype(synth_three_way{}(std::declval<T const &>(), std::declval<T const &>()));
+    auto const n1 = last1 - first1;
+    auto const n2 = last2 - first2;
+    for (std::ptrdiff_t n = std::min(n1, n2); n != 0;)
+    {
+        auto const k = std::min(contiguous_after(first1, n), contiguous_after(first2, n));
+        auto const p = raw_pointer(first1);
+        auto const q = raw_pointer(first2);
+        if constexpr (memcmp_ordered_v<T>)
+        {
+            if (auto const r = std::memcmp(p, q, static_cast<std::size_t>(k) * sizeof(T)); r != 0)
+                return static_cast<result>(r <=> 0);
+        }
+        else if constexpr (memcmp_equal_v<T>)
+        {
+            // memcmp finds the first run that differs, and the elements tell
+            // which way.
+            if (std::memcmp(p, q, static_cast<std::size_t>(k) * sizeof(T)) != 0)
+            {
+                auto const m = std::mismatch(p, p + k, q);
+                return static_cast<result>(*m.first <=> *m.second);
+            }
+        }
+        else
+        {
+            for (std::ptrdiff_t i = 0; i != k; ++i)
+                if (auto const c = synth_three_way{}(p[i], q[i]); c != 0)
+                    return c;
+        }
+        first1 += k;
+        first2 += k;
+        n -= k;
+    }
+    return static_cast<result>(n1 <=> n2);
+}
+
+} // namespace detail
+
+// A double-ended queue that keeps its elements in blocks, as std::deque does,
+// and addresses them through a map of block pointers. The map has room for
+// max_spare_blocks empty blocks after its slots; the blocks at either end
+// may hold no element yet, which is the capacity reserve_back and
+// reserve_front add to.
+template <class T, class Allocator = std::allocator<T>>
+class deque
+{
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using map_allocator = typename alloc_traits::template rebind_alloc<T *>;
+    using map_traits = std::allocator_traits<map_allocator>;
+    using layout = detail::block_layout<T>;
+
+    friend struct detail::deque_access;
+
+  public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = typename alloc_traits::size_type;
+    using difference_type = typename alloc_traits::difference_type;
+    using reference = T &;
+    using const_reference = T const &;
+    using pointer = typename alloc_traits::pointer;
+    using const_pointer = typename alloc_traits::const_pointer;
+    using iterator = deque_iterator<T, false, difference_type>;
+    using const_iterator = deque_iterator<T, true, difference_type>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // The number of empty blocks the deque keeps for reuse.
+    static constexpr std::size_t max_spare_blocks = detail::max_spare_blocks_v<T>;
+
+  private:
+    static constexpr std::ptrdiff_t spare_slots = static_cast<std::ptrdiff_t>(max_spare_blocks);
+    static constexpr std::ptrdiff_t min_map_size = 8;
+
+    [[no_unique_address]] Allocator alloc_;
+    // map_size_ slots, then room for the spare blocks.
+    T **map_ = nullptr;
+    std::ptrdiff_t map_size_ = 0;
+    // The slot of block 0; blocks first_block_ to last_block_ are allocated
+    // and every other slot is null.
+    std::ptrdiff_t origin_ = 0;
+    std::ptrdiff_t first_block_ = 0;
+    std::ptrdiff_t last_block_ = 0;
+    // The position of the first element.
+    std::ptrdiff_t first_ = 0;
+    size_type size_ = 0;
+    std::ptrdiff_t spare_count_ = 0;
+
+    std::ptrdiff_t end_pos() const noexcept
+    {
+        return first_ + static_cast<std::ptrdiff_t>(size_);
+    }
+
+    T *&block(std::ptrdiff_t j) const noexcept
+    {
+        return map_[origin_ + j];
+    }
+
+    T *element(std::ptrdiff_t s) const noexcept
+    {
+        auto const j = layout::block_of(s);
+        return block(j) + (s - layout::start(j));
+    }
+
+    T **spares() const noexcept
+    {
+        return map_ + map_size_;
+    }
+
+    T *const *origin() const noexcept
+    {
+        return map_ == nullptr ? nullptr : map_ + origin_;
+    }
+
+    // The elements from position s to the end of its block, at most n.
+    static std::ptrdiff_t run_after(std::ptrdiff_t s, std::ptrdiff_t n) noexcept
+    {
+        return std::min(layout::start(layout::block_of(s) + 1) - s, n);
+    }
+
+    // The elements from the start of the block of position e - 1 to e, at most n.
+    static std::ptrdiff_t run_before(std::ptrdiff_t e, std::ptrdiff_t n) noexcept
+    {
+        return std::min(e - layout::start(layout::block_of(e - 1)), n);
+    }
+
+    static void poison_block([[maybe_unused]] T *b, [[maybe_unused]] std::ptrdiff_t n) noexcept
+    {
+#if BIZWEN_DEQUE_ASAN
+        detail::annotate_block(b, b + n, b, b + n, b, b);
+#endif
+    }
+
+    static void unpoison_block([[maybe_unused]] T *b, [[maybe_unused]] std::ptrdiff_t n) noexcept
+    {
+#if BIZWEN_DEQUE_ASAN
+        detail::annotate_block(b, b + n, b, b, b, b + n);
+#endif
+    }
+
+    // Tells AddressSanitizer that the elements moved from positions
+    // [old_first, old_last) to [new_first, new_last); every block involved
+    // must be allocated.
+    void annotate([[maybe_unused]] std::ptrdiff_t old_first, [[maybe_unused]] std::ptrdiff_t old_last,
+                  [[maybe_unused]] std::ptrdiff_t new_first, [[maybe_unused]] std::ptrdiff_t new_last) const noexcept
+    {
+#if BIZWEN_DEQUE_ASAN
+        if (old_first == old_last && new_first == new_last)
+            return;
+        auto lo = old_first == old_last   ? new_first
+                  : new_first == new_last ? old_first
+                                          : std::min(old_first, new_first);
+        auto hi = old_first == old_last   ? new_last
+                  : new_first == new_last ? old_last
+                                          : std::max(old_last, new_last);
+        auto const jl = std::max(layout::block_of(lo), first_block_);
+        auto const jh = std::min(layout::block_of(hi - 1) + 1, last_block_);
+        for (auto j = jl; j < jh; ++j)
+        {
+            auto const bs = layout::start(j);
+            auto const be = bs + layout::size(j);
+            auto clamp = [&](std::ptrdiff_t &f, std::ptrdiff_t &l) {
+                f = std::clamp(f, bs, be);
+                l = std::clamp(l, bs, be);
+                if (f >= l)
+                    f = l = bs;
+            };
+            auto of = old_first, ol = old_last, nf = new_first, nl = new_last;
+            clamp(of, ol);
+            clamp(nf, nl);
+            if (of != nf || ol != nl)
+            {
+                T *const b = block(j);
+                detail::annotate_block(b, b + (be - bs), b + (of - bs), b + (ol - bs), b + (nf - bs), b + (nl - bs));
+            }
+        }
+#endif
+    }
+
+    // Hands out a spare block for block j if it is full size and one is
+    // left; a new block is poisoned as a whole.
+    T *allocate_block(std::ptrdiff_t j)
+    {
+        auto const n = layout::size(j);
+        if (n == static_cast<std::ptrdiff_t>(layout::max_elements) && spare_count_ != 0)
+            return spares()[--spare_count_];
+        T *const b = std::to_address(alloc_traits::allocate(alloc_, static_cast<size_type>(n)));
+        poison_block(b, n);
+        return b;
+    }
+
+    void deallocate_block(T *b, std::ptrdiff_t n) noexcept
+    {
+        unpoison_block(b, n);
+        alloc_traits::deallocate(alloc_, std::pointer_traits<pointer>::pointer_to(*b), static_cast<size_type>(n));
+    }
+
+    // Keeps an empty block of n elements as a spare if it is full size and
+    // there is room, and deallocates it otherwise.
+    void recycle_block(T *b, std::ptrdiff_t n) noexcept
+    {
+        if (n == static_cast<std::ptrdiff_t>(layout::max_elements) && spare_count_ < spare_slots)
+            spares()[spare_count_++] = b;
+        else
+            deallocate_block(b, n);
+    }
+
+    void release_block(std::ptrdiff_t j) noexcept
+    {
+        recycle_block(block(j), layout::size(j));
+        block(j) = nullptr;
+    }
+
+    void free_spares() noexcept
+    {
+        while (spare_count_ != 0)
+            deallocate_block(spares()[--spare_count_], static_cast<std::ptrdiff_t>(layout::max_elements));
+    }
+
+    T **allocate_map(std::ptrdiff_t n)
+    {
+        map_allocator a(alloc_);
+        auto const total = static_cast<typename map_traits::size_type>(n + spare_slots);
+        T **const m = std::to_address(map_traits::allocate(a, total));
+        std::uninitialized_fill_n(m, total, nullptr);
+        return m;
+    }
+
+    void deallocate_map() noexcept
+    {
+        if (map_ == nullptr)
+            return;
+        map_allocator a(alloc_);
+        map_traits::deallocate(a, std::pointer_traits<typename map_traits::pointer>::pointer_to(*map_),
+                               static_cast<typename map_traits::size_type>(map_size_ + spare_slots));
+        map_ = nullptr;
+        map_size_ = 0;
+        origin_ = 0;
+    }
+
+    // Moves the slots in use to map m of n slots, which may be the current
+    // map, leaving room for front blocks before them and back blocks after
+    // them and centering them in what is left. The blocks are renumbered so
+    // that block 0 stays within ramp_blocks of them: growing away from it
+    // then gets full-size blocks again.
+    void relocate_map(T **m, std::ptrdiff_t n, std::ptrdiff_t front, std::ptrdiff_t back) noexcept
+    {
+        auto const used = last_block_ - first_block_;
+        auto jb = first_block_;
+        if constexpr (layout::ramp_blocks == 0)
+            jb = 0;
+        else if (first_block_ >= layout::ramp_blocks)
+            jb = layout::ramp_blocks;
+        else if (last_block_ <= -layout::ramp_blocks)
+            jb = -layout::ramp_blocks - used;
+        auto const need = used + front + back + 2 * layout::ramp_blocks;
+        auto const lo = layout::ramp_blocks + front + (n - need) / 2;
+        if (map_ != nullptr)
+        {
+            auto const old_lo = origin_ + first_block_;
+            if (m == map_)
+            {
+                if (lo != old_lo)
+                {
+                    std::memmove(m + lo, m + old_lo, static_cast<std::size_t>(used) * sizeof(T *));
+                    if (lo < old_lo)
+                        std::fill(m + std::max(lo + used, old_lo), m + old_lo + used, nullptr);
+                    else
+                        std::fill(m + old_lo, m + std::min(lo, old_lo + used), nullptr);
+                }
+            }
+            else
+            {
+                std::copy(map_ + old_lo, map_ + old_lo + used, m + lo);
+                std::copy(spares(), spares() + spare_count_, m + n);
+                deallocate_map();
+            }
+        }
+        first_ += layout::start(jb) - layout::start(first_block_);
+        first_block_ = jb;
+        last_block_ = jb + used;
+        map_ = m;
+        map_size_ = n;
+        origin_ = lo - jb;
+    }
+
+    // Makes room in the map for front more blocks before the first one and
+    // back more after the last one. The map is reallocated only when the
+    // blocks would fill more than three quarters of it.
+    void reserve_map(std::ptrdiff_t front, std::ptrdiff_t back)
+    {
+        if (map_ != nullptr && origin_ + first_block_ >= front && map_size_ - (origin_ + last_block_) >= back)
+            return;
+        auto const need = last_block_ - first_block_ + front + back + 2 * layout::ramp_blocks;
+        if (map_ != nullptr && 4 * need <= 3 * map_size_)
+        {
+            relocate_map(map_, map_size_, front, back);
+            return;
+        }
+        auto const n = std::max({need + need / 2, 2 * map_size_, min_map_size});
+        relocate_map(allocate_map(n), n, front, back);
+    }
+
+    // Allocates the blocks for n more elements after the last one.
+    void grow_back(size_type n)
+    {
+        auto const want = end_pos() + static_cast<std::ptrdiff_t>(n);
+        if (want <= layout::start(last_block_))
+            return;
+        auto const blocks = layout::block_of(want - 1) + 1 - last_block_;
+        reserve_map(0, blocks);
+        auto j = last_block_;
+        try
+        {
+            for (; j != last_block_ + blocks; ++j)
+                block(j) = allocate_block(j);
+        }
+        catch (...)
+        {
+            while (j != last_block_)
+                release_block(--j);
+            throw;
+        }
+        last_block_ = j;
+    }
+
+    // Allocates the blocks for n more elements before the first one.
+    void grow_front(size_type n)
+    {
+        auto const want = first_ - static_cast<std::ptrdiff_t>(n);
+        if (want >= layout::start(first_block_))
+            return;
+        auto const blocks = first_block_ - layout::block_of(want);
+        reserve_map(blocks, 0);
+        auto j = first_block_;
+        try
+        {
+            for (; j != first_block_ - blocks; --j)
+                block(j - 1) = allocate_block(j - 1);
+        }
+        catch (...)
+        {
+            while (j != first_block_)
+                release_block(j++);
+            throw;
+        }
+        first_block_ = j;
+    }
+
+    // Gives back every block; the next one allocated is block 0 again.
+    void release_blocks() noexcept
+    {
+        while (last_block_ != first_block_)
+            release_block(--last_block_);
+        first_block_ = last_block_ = 0;
+        first_ = 0;
+    }
+
+    // After the first element moved on from old_first, gives back the
+    // blocks that held elements and no longer do. Blocks reserved before
+    // the elements are kept, and so are those between them.
+    void release_front(std::ptrdiff_t old_first) noexcept
+    {
+        if (size_ == 0)
+        {
+            release_blocks();
+            return;
+        }
+        if (layout::block_of(old_first) != first_block_)
+            return;
+        auto const j = layout::block_of(first_);
+        while (first_block_ != j)
+            release_block(first_block_++);
+    }
+
+    void release_back(std::ptrdiff_t old_end) noexcept
+    {
+        if (size_ == 0)
+        {
+            release_blocks();
+            return;
+        }
+        if (layout::block_of(old_end - 1) != last_block_ - 1)
+            return;
+        auto const j = layout::block_of(end_pos() - 1) + 1;
+        while (last_block_ != j)
+            release_block(--last_block_);
+    }
+
+    void destroy_range(std::ptrdiff_t first, std::ptrdiff_t last) noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<T> || detail::has_construct<Allocator, T>)
+        {
+            while (first != last)
+            {
+                auto const k = run_after(first, last - first);
+                T *const p = element(first);
+                for (std::ptrdiff_t i = 0; i != k; ++i)
+                    alloc_traits::destroy(alloc_, p + i);
+                first += k;
+            }
+        }
+    }
+
+    // Moves the bytes of the n elements at position from to position to;
+    // the ranges may overlap.
+    void relocate(std::ptrdiff_t from, std::ptrdiff_t to, std::ptrdiff_t n) noexcept
+    {
+        if (from == to)
+            return;
+        if (to < from)
+        {
+            while (n != 0)
+            {
+                auto const k = std::min(run_after(from, n), run_after(to, n));
+                std::memmove(static_cast<void *>(element(to)), static_cast<void const *>(element(from)),
+                             static_cast<std::size_t>(k) * sizeof(T));
+                from += k;
+                to += k;
+                n -= k;
+            }
+        }
+        else
+        {
+            from += n;
+            to += n;
+            while (n != 0)
+            {
+                auto const k = std::min(run_before(from, n), run_before(to, n));
+                from -= k;
+                to -= k;
+                std::memmove(static_cast<void *>(element(to)), static_cast<void const *>(element(from)),
+                             static_cast<std::size_t>(k) * sizeof(T));
+                n -= k;
+            }
+        }
+    }
+
+    // Constructs n elements at positions [first, first + n), which must be
+    // allocated, one contiguous run at a time: make(p, k) constructs the k
+    // elements at p or, if it throws, none of them. If one of them throws
+    // the elements constructed so far are destroyed.
+    template <class Make>
+    void construct_range(std::ptrdiff_t first, std::ptrdiff_t n, Make &&make)
+    {
+        auto s = first;
+        try
+        {
+            for (auto const last = first + n; s != last;)
+            {
+                auto const k = run_after(s, last - s);
+                make(element(s), k);
+                s += k;
+            }
+        }
+        catch (...)
+        {
+            destroy_range(first, s);
+            throw;
+        }
+    }
+
+    // Constructs k elements at p, or none of them, with construct(q) for each q.
+    template <class Construct>
+    void construct_run(T *p, std::ptrdiff_t k, Construct &&construct)
+    {
+        std::ptrdiff_t i = 0;
+        try
+        {
+            for (; i != k; ++i)
+                construct(p + i);
+        }
+        catch (...)
+        {
+            while (i != 0)
+                alloc_traits::destroy(alloc_, p + --i);
+            throw;
+        }
+    }
+
+    // Whether elements read through I can be copied into a block with memcpy.
+    template <class I>
+    static constexpr bool memcpy_from = std::contiguous_iterator<I> && std::is_same_v<std::iter_value_t<I>, T> &&
+                                        std::is_trivially_copyable_v<T> && !detail::has_construct<Allocator, T>;
+
+    // A maker for construct_range that copies, or moves, from first onwards.
+    template <class I>
+    auto make_from(I &first)
+    {
+        return [this, &first](T *p, std::ptrdiff_t k) {
+            if constexpr (memcpy_from<I>)
+            {
+                std::memcpy(static_cast<void *>(p), static_cast<void const *>(std::to_address(first)),
+                            static_cast<std::size_t>(k) * sizeof(T));
+                first += k;
+            }
+            else
+            {
+                construct_run(p, k, [this, &first](T *q) {
+                    alloc_traits::construct(alloc_, q, *first);
+                    ++first;
+                });
+            }
+        };
+    }
+
+    template <class... Args>
+    auto make_with(Args const &...args)
+    {
+        return [this, &args...](T *p, std::ptrdiff_t k) {
+            construct_run(p, k, [this, &args...](T *q) { alloc_traits::construct(alloc_, q, args...); });
+        };
+    }
+
+    // Constructs n elements after the last one with make; on an exception
+    // the deque is left as it was, bar the blocks it allocated.
+    template <class Make>
+    void append_with(size_type n, Make &&make)
+    {
+        if (n == 0)
+            return;
+        grow_back(n);
+        auto const finish = end_pos();
+        auto const m = static_cast<std::ptrdiff_t>(n);
+        annotate(first_, finish, first_, finish + m);
+        try
+        {
+            construct_range(finish, m, make);
+        }
+        catch (...)
+        {
+            annotate(first_, finish + m, first_, finish);
+            throw;
+        }
+        size_ += n;
+    }
+
+    template <class Make>
+    void prepend_with(size_type n, Make &&make)
+    {
+        if (n == 0)
+            return;
+        grow_front(n);
+        auto const finish = end_pos();
+        auto const m = static_cast<std::ptrdiff_t>(n);
+        annotate(first_, finish, first_ - m, finish);
+        try
+        {
+            construct_range(first_ - m, m, make);
+        }
+        catch (...)
+        {
+            annotate(first_ - m, finish, first_, finish);
+            throw;
+        }
+        first_ -= m;
+        size_ += n;
+    }
+
+    // Leaves n slots with no element at index i, moving the bytes of the
+    // elements on the shorter side of it. Returns whether the front side
+    // moved; close_gap takes the same answer to undo it.
+    bool open_gap(std::ptrdiff_t i, std::ptrdiff_t n)
+    {
+        if (i < static_cast<std::ptrdiff_t>(size_) - i)
+        {
+            grow_front(static_cast<size_type>(n));
+            auto const finish = end_pos();
+            annotate(first_, finish, first_ - n, finish);
+            relocate(first_, first_ - n, i);
+            first_ -= n;
+            size_ += static_cast<size_type>(n);
+            return true;
+        }
+        grow_back(static_cast<size_type>(n));
+        auto const finish = end_pos();
+        annotate(first_, finish, first_, finish + n);
+        relocate(first_ + i, first_ + i + n, static_cast<std::ptrdiff_t>(size_) - i);
+        size_ += static_cast<size_type>(n);
+        return false;
+    }
+
+    void close_gap(std::ptrdiff_t i, std::ptrdiff_t n, bool front) noexcept
+    {
+        auto const finish = end_pos();
+        size_ -= static_cast<size_type>(n);
+        if (front)
+        {
+            relocate(first_, first_ + n, i);
+            first_ += n;
+            annotate(first_ - n, finish, first_, finish);
+        }
+        else
+        {
+            relocate(first_ + i + n, first_ + i, static_cast<std::ptrdiff_t>(size_) - i);
+            annotate(first_, finish, first_, finish - n);
+        }
+    }
+
+    // Inserts n elements made by make at index i. Elements that can be
+    // relocated move aside in place; others are appended, or prepended,
+    // and rotated into position.
+    template <class Make>
+    iterator insert_with(std::ptrdiff_t i, size_type n, Make &&make)
+    {
+        auto const m = static_cast<std::ptrdiff_t>(n);
+        if (i == static_cast<std::ptrdiff_t>(size_))
+        {
+            append_with(n, make);
+        }
+        else if (i == 0)
+        {
+            prepend_with(n, make);
+        }
+        else if (n != 0)
+        {
+            if constexpr (is_trivially_relocatable_v<T>)
+            {
+                bool const front = open_gap(i, m);
+                try
+                {
+                    construct_range(first_ + i, m, make);
+                }
+                catch (...)
+                {
+                    close_gap(i, m, front);
+                    throw;
+                }
+            }
+            else if (i < static_cast<std::ptrdiff_t>(size_) - i)
+            {
+                prepend_with(n, make);
+                std::rotate(begin(), begin() + m, begin() + (m + i));
+            }
+            else
+            {
+                auto const old = static_cast<std::ptrdiff_t>(size_);
+                append_with(n, make);
+                std::rotate(begin() + i, begin() + old, end());
+            }
+        }
+        return begin() + i;
+    }
+
+    template <class I, class S>
+    iterator insert_iter(std::ptrdiff_t i, I first, S last)
+    {
+        if constexpr (std::sized_sentinel_for<S, I> || std::forward_iterator<I>)
+        {
+            auto const n = static_cast<size_type>(std::ranges::distance(first, last));
+            return insert_with(i, n, make_from(first));
+        }
+        else
+        {
+            auto const old = static_cast<std::ptrdiff_t>(size_);
+            if (i == 0 && old != 0)
+            {
+                try
+                {
+                    for (; first != last; ++first)
+                        emplace_front(*first);
+                }
+                catch (...)
+                {
+                    erase(begin(), end() - old);
+                    throw;
+                }
+                std::reverse(begin(), end() - old);
+                return begin();
+            }
+            try
+            {
+                for (; first != last; ++first)
+                    emplace_back(*first);
+            }
+            catch (...)
+            {
+                erase(begin() + old, end());
+                throw;
+            }
+            std::rotate(begin() + i, begin() + old, end());
+            return begin() + i;
+        }
+    }
+
+    // A sized range is inserted in one go even if its iterators cannot
+    // tell their distance.
+    template <class R>
+    iterator insert_range_at(std::ptrdiff_t i, R &range)
+    {
+        if constexpr (std::ranges::sized_range<R>)
+        {
+            auto first = std::ranges::begin(range);
+            return insert_with(i, static_cast<size_type>(std::ranges::size(range)), make_from(first));
+        }
+        else
+        {
+            return insert_iter(i, std::ranges::begin(range), std::ranges::end(range));
+        }
+    }
+
+    // Replaces the elements with those of [first, last), assigning over
+    // the ones in place and constructing the rest into the capacity at the
+    // back, so that only the blocks the deque lacks are allocated.
+    template <class I, class S>
+    void assign_iter(I first, S last)
+    {
+        auto s = first_;
+        auto const finish = end_pos();
+        while (s != finish && first != last)
+        {
+            auto const k = run_after(s, finish - s);
+            for (T *p = element(s), *const e = p + k; p != e && first != last; ++p, (void)++first, ++s)
+                *p = *first;
+        }
+        if (s != finish)
+            truncate(s);
+        else
+            append_iter(std::move(first), std::move(last));
+    }
+
+    template <class I, class S>
+    void append_iter(I first, S last)
+    {
+        if constexpr (std::sized_sentinel_for<S, I> || std::forward_iterator<I>)
+            append_with(static_cast<size_type>(std::ranges::distance(first, last)), make_from(first));
+        else
+            for (; first != last; ++first)
+                emplace_back(*first);
+    }
+
+    // Destroys the elements from position s on, keeping their blocks.
+    void truncate(std::ptrdiff_t s) noexcept
+    {
+        auto const finish = end_pos();
+        destroy_range(s, finish);
+        size_ = static_cast<size_type>(s - first_);
+        annotate(first_, finish, first_, s);
+    }
+
+    // Lends the algorithms a full-size block of uninitialized slots: a spare
+    // block if there is one, else a new block if allocate is set.
+    T *borrow_block(bool allocate)
+    {
+        T *b;
+        if (spare_count_ != 0)
+            b = spares()[--spare_count_];
+        else if (allocate)
+            return std::to_address(alloc_traits::allocate(alloc_, layout::max_elements));
+        else
+            return nullptr;
+        unpoison_block(b, static_cast<std::ptrdiff_t>(layout::max_elements));
+        return b;
+    }
+
+    void return_block(T *b) noexcept
+    {
+        auto const n = static_cast<std::ptrdiff_t>(layout::max_elements);
+        poison_block(b, n);
+        if (map_ != nullptr)
+            recycle_block(b, n);
+        else
+            deallocate_block(b, n);
+    }
+
+    void steal(deque &other) noexcept
+    {
+        map_ = std::exchange(other.map_, nullptr);
+        map_size_ = std::exchange(other.map_size_, 0);
+        origin_ = std::exchange(other.origin_, 0);
+        first_block_ = std::exchange(other.first_block_, 0);
+        last_block_ = std::exchange(other.last_block_, 0);
+        first_ = std::exchange(other.first_, 0);
+        size_ = std::exchange(other.size_, 0);
+        spare_count_ = std::exchange(other.spare_count_, 0);
+    }
+
+    void swap_storage(deque &other) noexcept
+    {
+        std::swap(map_, other.map_);
+        std::swap(map_size_, other.map_size_);
+        std::swap(origin_, other.origin_);
+        std::swap(first_block_, other.first_block_);
+        std::swap(last_block_, other.last_block_);
+        std::swap(first_, other.first_);
+        std::swap(size_, other.size_);
+        std::swap(spare_count_, other.spare_count_);
+    }
+
+    // Runs init, and frees whatever it allocated if it throws.
+    template <class Init>
+    void construct_with(Init &&init)
+    {
+        try
+        {
+            init();
+        }
+        catch (...)
+        {
+            release();
+            throw;
+        }
+    }
+
+  public:
+    deque() noexcept(std::is_nothrow_default_constructible_v<Allocator>) : alloc_()
+    {
+    }
+
+    explicit deque(Allocator const &alloc) noexcept : alloc_(alloc)
+    {
+    }
+
+    explicit deque(size_type n, Allocator const &alloc = Allocator()) : alloc_(alloc)
+    {
+        construct_with([&] { append_with(n, make_with()); });
+    }
+
+    deque(size_type n, T const &value, Allocator const &alloc = Allocator()) : alloc_(alloc)
+    {
+        construct_with([&] { append_with(n, make_with(value)); });
+    }
+
+    template <class I>
+        requires detail::input_iterator<I>
+    deque(I first, I last, Allocator const &alloc = Allocator()) : alloc_(alloc)
+    {
+        construct_with([&] { append_iter(std::move(first), std::move(last)); });
+    }
+
+#if defined(__cpp_lib_containers_ranges)
+    template <detail::container_compatible_range<T> R>
+    deque(std::from_range_t, R &&range, Allocator const &alloc = Allocator()) : alloc_(alloc)
+    {
+        construct_with([&] { append_range(std::forward<R>(range)); });
+    }
+#endif
+
+    deque(std::initializer_list<T> il, Allocator const &alloc = Allocator()) : alloc_(alloc)
+    {
+        construct_with([&] { append_iter(il.begin(), il.end()); });
+    }
+
+    deque(deque const &other) : alloc_(alloc_traits::select_on_container_copy_construction(other.alloc_))
+    {
+        construct_with([&] { append_iter(other.begin(), other.end()); });
+    }
+
+    deque(deque const &other, std::type_identity_t<Allocator> const &alloc) : alloc_(alloc)
+    {
+        construct_with([&] { append_iter(other.begin(), other.end()); });
+    }
+
+    deque(deque &&other) noexcept : alloc_(std::move(other.alloc_))
+    {
+        steal(other);
+    }
+
+    deque(deque &&other, std::type_identity_t<Allocator> const &alloc) : alloc_(alloc)
+    {
+        if (alloc_ == other.alloc_)
+            steal(other);
+        else
+            construct_with(
+                [&] { append_iter(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end())); });
+    }
+
+    ~deque()
+    {
+        release();
+    }
+
+    deque &operator=(deque const &other)
+    {
+        if (this == std::addressof(other))
+            return *this;
+        if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+        {
+            if (alloc_ != other.alloc_)
+                release();
+            alloc_ = other.alloc_;
+        }
+        assign_iter(other.begin(), other.end());
+        return *this;
+    }
+
+    deque &operator=(deque &&other) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                                             alloc_traits::is_always_equal::value)
+    {
+        if (this == std::addressof(other))
+            return *this;
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+        {
+            release();
+            alloc_ = std::move(other.alloc_);
+            steal(other);
+        }
+        else if (alloc_ == other.alloc_)
+        {
+            release();
+            steal(other);
+        }
+        else
+        {
+            assign_iter(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+        }
+        return *this;
+    }
+
+    deque &operator=(std::initializer_list<T> il)
+    {
+        assign_iter(il.begin(), il.end());
+        return *this;
+    }
+
+    template <class I>
+        requires detail::input_iterator<I>
+    void assign(I first, I last)
+    {
+        assign_iter(std::move(first), std::move(last));
+    }
+
+    void assign(size_type n, T const &value)
+    {
+        auto s = first_;
+        auto const finish = end_pos();
+        auto const last = first_ + static_cast<std::ptrdiff_t>(std::min(n, size_));
+        while (s != last)
+        {
+            auto const k = run_after(s, last - s);
+            std::fill_n(element(s), k, value);
+            s += k;
+        }
+        if (n < size_)
+            truncate(last);
+        else
+            append_with(n - static_cast<size_type>(finish - first_), make_with(value));
+    }
+
+    void assign(std::initializer_list<T> il)
+    {
+        assign_iter(il.begin(), il.end());
+    }
+
+    template <detail::container_compatible_range<T> R>
+    void assign_range(R &&range)
+    {
+        assign_iter(std::ranges::begin(range), std::ranges::end(range));
+    }
+
+    allocator_type get_allocator() const noexcept
+    {
+        return alloc_;
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator(origin(), first_);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(origin(), first_);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(origin(), end_pos());
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(origin(), end_pos());
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    const_reverse_iterator crbegin() const noexcept
+    {
+        return rbegin();
+    }
+
+    const_reverse_iterator crend() const noexcept
+    {
+        return rend();
+    }
+
+    // The elements as contiguous spans, one per block.
+    auto segments() noexcept
+    {
+        return bizwen::segments(begin(), end());
+    }
+
+    auto segments() const noexcept
+    {
+        return bizwen::segments(begin(), end());
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    size_type size() const noexcept
+    {
+        return size_;
+    }
+
+    size_type max_size() const noexcept
+    {
+        constexpr auto limit =
+            std::min(static_cast<std::size_t>(std::numeric_limits<difference_type>::max()),
+                     static_cast<std::size_t>(std::numeric_limits<std::ptrdiff_t>::max()) / sizeof(T));
+        return static_cast<size_type>(std::min(static_cast<std::size_t>(alloc_traits::max_size(alloc_)), limit));
+    }
+
+    void resize(size_type n)
+    {
+        if (n < size_)
+            erase(begin() + static_cast<difference_type>(n), end());
+        else
+            append_with(n - size_, make_with());
+    }
+
+    void resize(size_type n, T const &value)
+    {
+        if (n < size_)
+            erase(begin() + static_cast<difference_type>(n), end());
+        else
+            append_with(n - size_, make_with(value));
+    }
+
+    // Frees the spare blocks, the blocks that hold no element and, if it
+    // can, the map slots no block uses.
+    void shrink_to_fit() noexcept
+    {
+        free_spares();
+        if (size_ == 0)
+        {
+            release_blocks();
+            free_spares();
+            deallocate_map();
+            return;
+        }
+        auto const jb = layout::block_of(first_);
+        auto const je = layout::block_of(end_pos() - 1) + 1;
+        while (first_block_ != jb)
+        {
+            deallocate_block(block(first_block_), layout::size(first_block_));
+            block(first_block_++) = nullptr;
+        }
+        while (last_block_ != je)
+        {
+            --last_block_;
+            deallocate_block(block(last_block_), layout::size(last_block_));
+            block(last_block_) = nullptr;
+        }
+        auto const n = last_block_ - first_block_ + 2 * layout::ramp_blocks;
+        if (n < map_size_)
+        {
+            try
+            {
+                relocate_map(allocate_map(n), n, 0, 0);
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+
+    // Allocates the blocks for n more elements at the back, or front, so
+    // that that many can be added there without allocating.
+    void reserve_back(size_type n)
+    {
+        if (n > max_size() - size_)
+            throw std::length_error("bizwen::deque::reserve_back");
+        grow_back(n);
+    }
+
+    void reserve_front(size_type n)
+    {
+        if (n > max_size() - size_)
+            throw std::length_error("bizwen::deque::reserve_front");
+        grow_front(n);
+    }
+
+    // The elements that fit before the first one, or after the last one,
+    // in the blocks already allocated.
+    size_type capacity_front() const noexcept
+    {
+        return static_cast<size_type>(first_ - layout::start(first_block_));
+    }
+
+    size_type capacity_back() const noexcept
+    {
+        return static_cast<size_type>(layout::start(last_block_) - end_pos());
+    }
+
+    size_type block_count() const noexcept
+    {
+        return static_cast<size_type>(last_block_ - first_block_);
+    }
+
+    size_type map_capacity() const noexcept
+    {
+        return static_cast<size_type>(map_size_);
+    }
+
+    // The whole block that holds the element at it, slots with no element
+    // included.
+    std::span<T const> block_extent(const_iterator it) const noexcept
+    {
+        auto const j = layout::block_of(it.position());
+        return std::span<T const>(block(j), static_cast<std::size_t>(layout::size(j)));
+    }
+
+    // Whether AddressSanitizer sees the slots of every block outside the
+    // elements, and every slot of the spare blocks, as poisoned.
+    bool verify_asan_annotations() const noexcept
+    {
+#if BIZWEN_DEQUE_ASAN
+        auto const finish = end_pos();
+        for (auto j = first_block_; j != last_block_; ++j)
+        {
+            auto const bs = layout::start(j);
+            auto const be = bs + layout::size(j);
+            auto f = std::clamp(first_, bs, be);
+            auto l = std::clamp(finish, bs, be);
+            if (f >= l)
+                f = l = bs;
+            T const *const b = block(j);
+            if (!__sanitizer_verify_double_ended_contiguous_container(b, b + (f - bs), b + (l - bs), b + (be - bs)))
+                return false;
+        }
+        for (auto i = std::ptrdiff_t{}; i != spare_count_; ++i)
+        {
+            T const *const b = spares()[i];
+            if (!__sanitizer_verify_double_ended_contiguous_container(b, b, b, b + layout::max_elements))
+                return false;
+        }
+#endif
+        return true;
+    }
+
+    reference operator[](size_type i) noexcept
+    {
+        return *element(first_ + static_cast<std::ptrdiff_t>(i));
+    }
+
+    const_reference operator[](size_type i) const noexcept
+    {
+        return *element(first_ + static_cast<std::ptrdiff_t>(i));
+    }
+
+    reference at(size_type i)
+    {
+        if (i >= size_)
+            throw std::out_of_range("bizwen::deque::at");
+        return (*this)[i];
+    }
+
+    const_reference at(size_type i) const
+    {
+        if (i >= size_)
+            throw std::out_of_range("bizwen::deque::at");
+        return (*this)[i];
+    }
+
+    reference front() noexcept
+    {
+        return *element(first_);
+    }
+
+    const_reference front() const noexcept
+    {
+        return *element(first_);
+    }
+
+    reference back() noexcept
+    {
+        return *element(end_pos() - 1);
+    }
+
+    const_reference back() const noexcept
+    {
+        return *element(end_pos() - 1);
+    }
+
+    template <class... Args>
+    reference emplace_back(Args &&...args)
+    {
+        if (end_pos() == layout::start(last_block_))
+            grow_back(1);
+        auto const finish = end_pos();
+        annotate(first_, finish, first_, finish + 1);
+        T *const p = element(finish);
+        try
+        {
+            alloc_traits::construct(alloc_, p, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            annotate(first_, finish + 1, first_, finish);
+            throw;
+        }
+        ++size_;
+        return *p;
+    }
+
+    template <class... Args>
+    reference emplace_front(Args &&...args)
+    {
+        if (first_ == layout::start(first_block_))
+            grow_front(1);
+        auto const finish = end_pos();
+        annotate(first_, finish, first_ - 1, finish);
+        T *const p = element(first_ - 1);
+        try
+        {
+            alloc_traits::construct(alloc_, p, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            annotate(first_ - 1, finish, first_, finish);
+            throw;
+        }
+        --first_;
+        ++size_;
+        return *p;
+    }
+
+    void push_back(T const &value)
+    {
+        emplace_back(value);
+    }
+
+    void push_back(T &&value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    void push_front(T const &value)
+    {
+        emplace_front(value);
+    }
+
+    void push_front(T &&value)
+    {
+        emplace_front(std::move(value));
+    }
+
+    void pop_back() noexcept
+    {
+        auto const finish = end_pos();
+        alloc_traits::destroy(alloc_, element(finish - 1));
+        --size_;
+        annotate(first_, finish, first_, finish - 1);
+        release_back(finish);
+    }
+
+    void pop_front() noexcept
+    {
+        auto const finish = end_pos();
+        alloc_traits::destroy(alloc_, element(first_));
+        ++first_;
+        --size_;
+        annotate(first_ - 1, finish, first_, finish);
+        release_front(first_ - 1);
+    }
+
+    template <detail::container_compatible_range<T> R>
+    void append_range(R &&range)
+    {
+        insert_range_at(static_cast<std::ptrdiff_t>(size_), range);
+    }
+
+    template <detail::container_compatible_range<T> R>
+    void prepend_range(R &&range)
+    {
+        insert_range_at(0, range);
+    }
+
+    template <detail::container_compatible_range<T> R>
+    iterator insert_range(const_iterator pos, R &&range)
+    {
+        return insert_range_at(pos - cbegin(), range);
+    }
+
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args &&...args)
+    {
+        auto const i = static_cast<std::ptrdiff_t>(pos - cbegin());
+        if (i == static_cast<std::ptrdiff_t>(size_))
+        {
+            emplace_back(std::forward<Args>(args)...);
+            return end() - 1;
+        }
+        if (i == 0)
+        {
+            emplace_front(std::forward<Args>(args)...);
+            return begin();
+        }
+        // The arguments may refer to an element, so the new one is made
+        // before any of them moves.
+        alignas(T) unsigned char buffer[sizeof(T)];
+        T *const tmp = reinterpret_cast<T *>(buffer);
+        alloc_traits::construct(alloc_, tmp, std::forward<Args>(args)...);
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            try
+            {
+                open_gap(i, 1);
+            }
+            catch (...)
+            {
+                alloc_traits::destroy(alloc_, tmp);
+                throw;
+            }
+            std::memcpy(static_cast<void *>(element(first_ + i)), static_cast<void const *>(buffer), sizeof(T));
+        }
+        else
+        {
+            try
+            {
+                if (i < static_cast<std::ptrdiff_t>(size_) - i)
+                {
+                    emplace_front(std::move(front()));
+                    bizwen::move(begin() + 2, begin() + (i + 1), begin() + 1);
+                }
+                else
+                {
+                    emplace_back(std::move(back()));
+                    bizwen::move_backward(begin() + i, end() - 2, end() - 1);
+                }
+                *element(first_ + i) = std::move(*tmp);
+            }
+            catch (...)
+            {
+                alloc_traits::destroy(alloc_, tmp);
+                throw;
+            }
+            alloc_traits::destroy(alloc_, tmp);
+        }
+        return begin() + i;
+    }
+
+    iterator insert(const_iterator pos, T const &value)
+    {
+        return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, T &&value)
+    {
+        return emplace(pos, std::move(value));
+    }
+
+    iterator insert(const_iterator pos, size_type n, T const &value)
+    {
+        auto const i = static_cast<std::ptrdiff_t>(pos - cbegin());
+        if (n == 0)
+            return begin() + i;
+        // value may be one of the elements that are about to move.
+        alignas(T) unsigned char buffer[sizeof(T)];
+        T *const tmp = reinterpret_cast<T *>(buffer);
+        alloc_traits::construct(alloc_, tmp, value);
+        try
+        {
+            insert_with(i, n, make_with(std::as_const(*tmp)));
+        }
+        catch (...)
+        {
+            alloc_traits::destroy(alloc_, tmp);
+            throw;
+        }
+        alloc_traits::destroy(alloc_, tmp);
+        return begin() + i;
+    }
+
+    template <class I>
+        requires detail::input_iterator<I>
+    iterator insert(const_iterator pos, I first, I last)
+    {
+        return insert_iter(pos - cbegin(), std::move(first), std::move(last));
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> il)
+    {
+        return insert_iter(pos - cbegin(), il.begin(), il.end());
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    // Closes the gap from the shorter side, and gives back the blocks at
+    // that end that are left without an element.
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        auto const i = static_cast<std::ptrdiff_t>(first - cbegin());
+        auto const n = static_cast<std::ptrdiff_t>(last - first);
+        if (n == 0)
+            return begin() + i;
+        auto const last_pos = end_pos();
+        auto const after = static_cast<std::ptrdiff_t>(size_) - i - n;
+        if (i < after)
+        {
+            if constexpr (is_trivially_relocatable_v<T>)
+            {
+                destroy_range(first_ + i, first_ + i + n);
+                relocate(first_, first_ + n, i);
+            }
+            else
+            {
+                bizwen::move_backward(begin(), begin() + i, begin() + (i + n));
+                destroy_range(first_, first_ + n);
+            }
+            auto const old_first = first_;
+            first_ += n;
+            size_ -= static_cast<size_type>(n);
+            annotate(old_first, last_pos, first_, last_pos);
+            release_front(old_first);
+        }
+        else
+        {
+            if constexpr (is_trivially_relocatable_v<T>)
+            {
+                destroy_range(first_ + i, first_ + i + n);
+                relocate(first_ + i + n, first_ + i, after);
+            }
+            else
+            {
+                bizwen::move(begin() + (i + n), end(), begin() + i);
+                destroy_range(last_pos - n, last_pos);
+            }
+            size_ -= static_cast<size_type>(n);
+            annotate(first_, last_pos, first_, last_pos - n);
+            release_back(last_pos);
+        }
+        return begin() + i;
+    }
+
+    void swap(deque &other) noexcept
+    {
+        if constexpr (alloc_traits::propagate_on_container_swap::value)
+        {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        }
+        swap_storage(other);
+    }
+
+    // Destroys the elements and keeps the spare blocks and the map.
+    void clear() noexcept
+    {
+        truncate(first_);
+        release_blocks();
+    }
+
+    // Destroys the elements and keeps every block, so that refilling the
+    // deque allocates nothing.
+    void clear_keep_capacity() noexcept
+    {
+        truncate(first_);
+        first_ = layout::start(first_block_);
+    }
+
+    // Destroys the elements and frees every block, spare or not, and the map.
+    void release() noexcept
+    {
+        truncate(first_);
+        release_blocks();
+        free_spares();
+        deallocate_map();
+    }
+
+    friend void swap(deque &lhs, deque &rhs) noexcept(noexcept(lhs.swap(rhs)))
+    {
+        lhs.swap(rhs);
+    }
+
+    friend bool operator==(deque const &lhs, deque const &rhs)
+    {
+        return lhs.size_ == rhs.size_ && detail::segments_equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    friend auto operator<=>(deque const &lhs, deque const &rhs)
+        requires requires(T const &x) { x < x; }
+    {
+        return detail::segments_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+};
+
+namespace detail
+{
+
+struct deque_access
+{
+    template <class T, class Allocator>
+    static T *borrow_block(deque<T, Allocator> &c, bool allocate)
+    {
+        return c.borrow_block(allocate);
+    }
+
+    template <class T, class Allocator>
+    static void return_block(deque<T, Allocator> &c, T *b) noexcept
+    {
+        c.return_block(b);
+    }
+};
+
+} // namespace detail
+
+template <class I, class Allocator = std::allocator<std::iter_value_t<I>>>
+    requires detail::input_iterator<I>
+deque(I, I, Allocator = Allocator()) -> deque<std::iter_value_t<I>, Allocator>;
+
+#if defined(__cpp_lib_containers_ranges)
+template <std::ranges::input_range R, class Allocator = std::allocator<std::ranges::range_value_t<R>>>
+deque(std::from_range_t, R &&, Allocator = Allocator()) -> deque<std::ranges::range_value_t<R>, Allocator>;
+#endif
+
+// Erases the elements equal to value, or for which pred holds, in one pass
+// that moves each kept element once, and returns how many were erased.
+template <class T, class Allocator, class Pred>
+typename deque<T, Allocator>::size_type erase_if(deque<T, Allocator> &c, Pred pred)
+{
+    auto const first = c.begin();
+    auto const last = c.end();
+    auto out = first;
+    for (auto segment : bizwen::segments(first, last))
+    {
+        for (auto &elem : segment)
+        {
+            if (!pred(elem))
+            {
+                if (std::addressof(*out) != std::addressof(elem))
+                    *out = std::move(elem);
+                ++out;
+            }
+        }
+    }
+    auto const n = static_cast<typename deque<T, Allocator>::size_type>(last - out);
+    c.erase(out, last);
+    return n;
+}
+
+template <class T, class Allocator, class U>
+typename deque<T, Allocator>::size_type erase(deque<T, Allocator> &c, U const &value)
+{
+    return bizwen::erase_if(c, [&](auto &elem) { return elem == value; });
+}
+
+// A deque that keeps up to N elements inside the object, in a ring, and
+// moves them to the blocks of a deque<T, Allocator> the first time one more
+// is inserted. They stay there until shrink_to_fit() finds that they fit
+// inline again. The inline elements are constructed in place rather than
+// through the allocator, and AddressSanitizer annotations cover the heap
+// blocks only.
+//
+// An iterator holds the small_deque and the position of its element counted
+// from a fixed origin, so that removing elements at either end does not
+// move the others.
+template <class T, std::size_t N, class Allocator = std::allocator<T>>
+class small_deque
+{
+    static_assert(N != 0, "small_deque needs room for at least one inline element");
+
+    using heap_type = deque<T, Allocator>;
+
+    template <bool Const>
+    class basic_iterator
+    {
+        friend class small_deque;
+        template <bool>
+        friend class basic_iterator;
+
+        using owner_type = std::conditional_t<Const, small_deque const, small_deque>;
+
+        owner_type *owner_ = nullptr;
+        std::ptrdiff_t pos_ = 0;
+
+        constexpr basic_iterator(owner_type *owner, std::ptrdiff_t pos) noexcept : owner_(owner), pos_(pos)
+        {
+        }
+
+      public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, T const *, T *>;
+        using reference = std::conditional_t<Const, T const &, T &>;
+
+        constexpr basic_iterator() noexcept = default;
+
+        template <bool OtherConst>
+            requires(Const && !OtherConst)
+        constexpr basic_iterator(basic_iterator<OtherConst> const &other) noexcept
+            : owner_(other.owner_), pos_(other.pos_)
+        {
+        }
+
+        reference operator*() const noexcept
+        {
+            return *owner_->element(pos_);
+        }
+
+        pointer operator->() const noexcept
+        {
+            return owner_->element(pos_);
+        }
+
+        reference operator[](difference_type n) const noexcept
+        {
+            return *owner_->element(pos_ + n);
+        }
+
+        basic_iterator &operator++() noexcept
+        {
+            ++pos_;
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept
+        {
+            auto tmp = *this;
+            ++pos_;
+            return tmp;
+        }
+
+        basic_iterator &operator--() noexcept
+        {
+            --pos_;
+            return *this;
+        }
+
+        basic_iterator operator--(int) noexcept
+        {
+            auto tmp = *this;
+            --pos_;
+            return tmp;
+        }
+
+        basic_iterator &operator+=(difference_type n) noexcept
+        {
+            pos_ += n;
+            return *this;
+        }
+
+        basic_iterator &operator-=(difference_type n) noexcept
+        {
+            pos_ -= n;
+            return *this;
+        }
+
+        friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept
+        {
+            it.pos_ += n;
+            return it;
+        }
+
+        friend basic_iterator operator+(difference_type n, basic_iterator it) noexcept
+        {
+            it.pos_ += n;
+            return it;
+        }
+
+        friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept
+        {
+            it.pos_ -= n;
+            return it;
+        }
+
+        friend difference_type operator-(basic_iterator const &lhs, basic_iterator const &rhs) noexcept
+        {
+            return lhs.pos_ - rhs.pos_;
+        }
+
+        friend bool operator==(basic_iterator const &lhs, basic_iterator const &rhs) noexcept
+        {
+            return lhs.pos_ == rhs.pos_;
+        }
+
+        friend std::strong_ordering operator<=>(basic_iterator const &lhs, basic_iterator const &rhs) noexcept
+        {
+            return lhs.pos_ <=> rhs.pos_;
+        }
+    };
+
+  public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T &;
+    using const_reference = T const &;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  private:
+    static constexpr std::ptrdiff_t ring_size = static_cast<std::ptrdiff_t>(N);
+
+    alignas(T) unsigned char storage_[sizeof(T) * N];
+    heap_type heap_;
+    // The position of the first element; an inline element at position s
+    // is in slot s mod N.
+    std::ptrdiff_t first_ = 0;
+    size_type size_ = 0;
+    bool inline_ = true;
+
+    T *slot(std::ptrdiff_t s) const noexcept
+    {
+        auto const i = (s % ring_size + ring_size) % ring_size;
+        return std::launder(reinterpret_cast<T *>(const_cast<unsigned char *>(storage_))) + i;
+    }
+
+    T *element(std::ptrdiff_t s) const noexcept
+    {
+        if (inline_)
+            return slot(s);
+        return const_cast<T *>(std::addressof(heap_[static_cast<size_type>(s - first_)]));
+    }
+
+    std::ptrdiff_t end_pos() const noexcept
+    {
+        return first_ + static_cast<std::ptrdiff_t>(size_);
+    }
+
+    void destroy_inline() noexcept
+    {
+        for (auto s = first_; s != end_pos(); ++s)
+            std::destroy_at(slot(s));
+    }
+
+    // Moves the inline elements to the heap, with room for one more.
+    void spill()
+    {
+        heap_.reserve_back(size_ + 1);
+        try
+        {
+            for (auto s = first_; s != end_pos(); ++s)
+                heap_.emplace_back(std::move(*slot(s)));
+        }
+        catch (...)
+        {
+            heap_.clear();
+            throw;
+        }
+        destroy_inline();
+        inline_ = false;
+    }
+
+    // Takes the elements of other, which must be empty here.
+    void take(small_deque &other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if (other.inline_)
+        {
+            first_ = other.first_;
+            for (auto s = other.first_; s != other.end_pos(); ++s)
+            {
+                std::construct_at(slot(s), std::move(*other.slot(s)));
+                ++size_;
+            }
+            other.clear();
+        }
+        else
+        {
+            heap_ = std::move(other.heap_);
+            inline_ = false;
+            first_ = std::exchange(other.first_, 0);
+            size_ = std::exchange(other.size_, 0);
+            other.inline_ = true;
+        }
+    }
+
+  public:
+    small_deque() noexcept(std::is_nothrow_default_constructible_v<Allocator>) = default;
+
+    explicit small_deque(Allocator const &alloc) noexcept : heap_(alloc)
+    {
+    }
+
+    explicit small_deque(size_type n, Allocator const &alloc = Allocator()) : heap_(alloc)
+    {
+        for (; n != 0; --n)
+            emplace_back();
+    }
+
+    small_deque(size_type n, T const &value, Allocator const &alloc = Allocator()) : heap_(alloc)
+    {
+        for (; n != 0; --n)
+            push_back(value);
+    }
+
+    template <class I>
+        requires detail::input_iterator<I>
+    small_deque(I first, I last, Allocator const &alloc = Allocator()) : heap_(alloc)
+    {
+        for (; first != last; ++first)
+            emplace_back(*first);
+    }
+
+    small_deque(std::initializer_list<T> il, Allocator const &alloc = Allocator())
+        : small_deque(il.begin(), il.end(), alloc)
+    {
+    }
+
+    small_deque(small_deque const &other) : heap_(other.heap_.get_allocator())
+    {
+        for (auto const &elem : other)
+            push_back(elem);
+    }
+
+    // Heap storage is handed over, so references to its elements stay
+    // valid; inline elements are moved one by one.
+    small_deque(small_deque &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : heap_(other.heap_.get_allocator())
+    {
+        take(other);
+    }
+
+    ~small_deque()
+    {
+        if (inline_)
+            destroy_inline();
+    }
+
+    small_deque &operator=(small_deque const &other)
+    {
+        if (this != std::addressof(other))
+        {
+            clear();
+            for (auto const &elem : other)
+                push_back(elem);
+        }
+        return *this;
+    }
+
+    small_deque &operator=(small_deque &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this != std::addressof(other))
+        {
+            if (inline_)
+                destroy_inline();
+            heap_.release();
+            first_ = 0;
+            size_ = 0;
+            inline_ = true;
+            take(other);
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const noexcept
+    {
+        return heap_.get_allocator();
+    }
+
+    static constexpr size_type inline_capacity() noexcept
+    {
+        return N;
+    }
+
+    // Whether the elements are stored inside the object.
+    bool is_inline() const noexcept
+    {
+        return inline_;
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator(this, first_);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, first_);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(this, end_pos());
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, end_pos());
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    size_type size() const noexcept
+    {
+        return size_;
+    }
+
+    size_type max_size() const noexcept
+    {
+        return heap_.max_size();
+    }
+
+    reference operator[](size_type i) noexcept
+    {
+        return *element(first_ + static_cast<std::ptrdiff_t>(i));
+    }
+
+    const_reference operator[](size_type i) const noexcept
+    {
+        return *element(first_ + static_cast<std::ptrdiff_t>(i));
+    }
+
+    reference at(size_type i)
+    {
+        if (i >= size_)
+            throw std::out_of_range("bizwen::small_deque::at");
+        return (*this)[i];
+    }
+
+    const_reference at(size_type i) const
+    {
+        if (i >= size_)
+            throw std::out_of_range("bizwen::small_deque::at");
+        return (*this)[i];
+    }
+
+    reference front() noexcept
+    {
+        return *element(first_);
+    }
+
+    const_reference front() const noexcept
+    {
+        return *element(first_);
+    }
+
+    reference back() noexcept
+    {
+        return *element(end_pos() - 1);
+    }
+
+    const_reference back() const noexcept
+    {
+        return *element(end_pos() - 1);
+    }
+
+    template <class... Args>
+    reference emplace_back(Args &&...args)
+    {
+        if (inline_ && size_ == N)
+            spill();
+        T *p;
+        if (inline_)
+            p = std::construct_at(slot(end_pos()), std::forward<Args>(args)...);
+        else
+            p = std::addressof(heap_.emplace_back(std::forward<Args>(args)...));
+        ++size_;
+        return *p;
+    }
+
+    template <class... Args>
+    reference emplace_front(Args &&...args)
+    {
+        if (inline_ && size_ == N)
+            spill();
+        T *p;
+        if (inline_)
+            p = std::construct_at(slot(first_ - 1), std::forward<Args>(args)...);
+        else
+            p = std::addressof(heap_.emplace_front(std::forward<Args>(args)...));
+        --first_;
+        ++size_;
+        return *p;
+    }
+
+    void push_back(T const &value)
+    {
+        emplace_back(value);
+    }
+
+    void push_back(T &&value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    void push_front(T const &value)
+    {
+        emplace_front(value);
+    }
+
+    void push_front(T &&value)
+    {
+        emplace_front(std::move(value));
+    }
+
+    void pop_back() noexcept
+    {
+        if (inline_)
+            std::destroy_at(slot(end_pos() - 1));
+        else
+            heap_.pop_back();
+        --size_;
+    }
+
+    void pop_front() noexcept
+    {
+        if (inline_)
+            std::destroy_at(slot(first_));
+        else
+            heap_.pop_front();
+        ++first_;
+        --size_;
+    }
+
+    // Inline, the new element goes in at the nearer end and is rotated into
+    // place; on the heap it is inserted as deque inserts it.
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args &&...args)
+    {
+        auto const i = pos - cbegin();
+        if (inline_ && size_ == N)
+            spill();
+        if (!inline_ && i == 0)
+        {
+            emplace_front(std::forward<Args>(args)...);
+            return begin();
+        }
+        if (!inline_)
+        {
+            heap_.emplace(heap_.cbegin() + i, std::forward<Args>(args)...);
+            ++size_;
+            return begin() + i;
+        }
+        T tmp(std::forward<Args>(args)...);
+        if (i < static_cast<std::ptrdiff_t>(size_) - i)
+        {
+            emplace_front(std::move(tmp));
+            std::rotate(begin(), begin() + 1, begin() + (i + 1));
+        }
+        else
+        {
+            emplace_back(std::move(tmp));
+            std::rotate(begin() + i, end() - 1, end());
+        }
+        return begin() + i;
+    }
+
+    iterator insert(const_iterator pos, T const &value)
+    {
+        return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, T &&value)
+    {
+        return emplace(pos, std::move(value));
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        auto const i = first - cbegin();
+        auto const n = last - first;
+        if (!inline_)
+        {
+            heap_.erase(heap_.cbegin() + i, heap_.cbegin() + (i + n));
+            size_ -= static_cast<size_type>(n);
+            if (i == 0)
+                first_ += n;
+            return begin() + i;
+        }
+        if (i < static_cast<std::ptrdiff_t>(size_) - i - n)
+        {
+            std::move_backward(begin(), begin() + i, begin() + (i + n));
+            for (auto k = n; k != 0; --k)
+                pop_front();
+        }
+        else
+        {
+            std::move(begin() + (i + n), end(), begin() + i);
+            for (auto k = n; k != 0; --k)
+                pop_back();
+        }
+        return begin() + i;
+    }
+
+    // Destroys the elements; heap storage stays until shrink_to_fit().
+    void clear() noexcept
+    {
+        if (inline_)
+            destroy_inline();
+        else
+            heap_.clear();
+        first_ = 0;
+        size_ = 0;
+    }
+
+    // Moves the elements back inline if they fit, and frees the heap
+    // storage; otherwise shrinks the heap storage.
+    void shrink_to_fit()
+    {
+        if (inline_)
+            return;
+        if (size_ > N)
+        {
+            heap_.shrink_to_fit();
+            return;
+        }
+        auto s = first_;
+        try
+        {
+            for (; s != end_pos(); ++s)
+                std::construct_at(slot(s), std::move(heap_[static_cast<size_type>(s - first_)]));
+        }
+        catch (...)
+        {
+            while (s != first_)
+                std::destroy_at(slot(--s));
+            throw;
+        }
+        heap_.release();
+        inline_ = true;
+    }
+
+    void swap(small_deque &other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        small_deque tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    friend void swap(small_deque &lhs, small_deque &rhs) noexcept(noexcept(lhs.swap(rhs)))
+    {
+        lhs.swap(rhs);
+    }
+
+    // Whether AddressSanitizer sees the heap blocks as the deque left them.
+    bool verify_asan_annotations() const noexcept
+    {
+        return heap_.verify_asan_annotations();
+    }
+
+    friend bool operator==(small_deque const &lhs, small_deque const &rhs)
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    friend auto operator<=>(small_deque const &lhs, small_deque const &rhs)
+        requires requires(T const &x) { x < x; }
+    {
+        return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                                                      detail::synth_three_way{});
+    }
+};
+
+namespace detail
+{
+
+// Keeps the members one thread writes away from those another thread does.
+inline constexpr std::size_t cache_line = 64;
+
+} // namespace detail
+
+// A FIFO queue for one producer thread and one consumer thread. The elements
+// live in blocks of block_elements_v<T> slots, as in deque, linked from the
+// oldest to the newest. The producer publishes how many elements it pushed
+// with a release store and the consumer how many it popped; a block the
+// consumer has emptied goes back to the producer through a free list of up
+// to max_spare_blocks blocks, which only the producer takes from.
+template <class T, class Allocator = std::allocator<T>>
+class spsc_deque
+{
+    static constexpr std::size_t block_size = detail::block_elements_v<T>;
+
+    struct block
+    {
+        block *next = nullptr;
+        block *free_next = nullptr;
+        alignas(T) unsigned char storage[sizeof(T) * block_size];
+
+        T *slot(std::size_t i) noexcept
+        {
+            return std::launder(reinterpret_cast<T *>(storage)) + i;
+        }
+    };
+
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using block_allocator = typename alloc_traits::template rebind_alloc<block>;
+    using block_traits = std::allocator_traits<block_allocator>;
+
+  public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using reference = T &;
+    using const_reference = T const &;
+
+  private:
+    [[no_unique_address]] Allocator alloc_;
+
+    // The producer's side.
+    alignas(detail::cache_line) block *tail_block_ = nullptr;
+    std::size_t tail_ = 0;
+    std::atomic<std::size_t> pushed_{0};
+
+    // The consumer's side.
+    alignas(detail::cache_line) block *head_block_ = nullptr;
+    std::size_t head_ = 0;
+    std::size_t popped_local_ = 0;
+    std::atomic<std::size_t> popped_{0};
+
+    // Blocks on their way from the consumer back to the producer.
+    alignas(detail::cache_line) std::atomic<block *> free_{nullptr};
+    std::atomic<std::size_t> free_count_{0};
+
+    block *allocate_block()
+    {
+        block_allocator a(alloc_);
+        block *const b = std::to_address(block_traits::allocate(a, 1));
+        ::new (static_cast<void *>(b)) block;
+        return b;
+    }
+
+    void deallocate_block(block *b) noexcept
+    {
+        block_allocator a(alloc_);
+        b->~block();
+        block_traits::deallocate(a, std::pointer_traits<typename block_traits::pointer>::pointer_to(*b), 1);
+    }
+
+    // Called by the producer only, so a block cannot be taken and put back
+    // between the load and the compare-and-swap.
+    block *take_block()
+    {
+        block *b = free_.load(std::memory_order_acquire);
+        while (b != nullptr && !free_.compare_exchange_weak(b, b->free_next, std::memory_order_acquire))
+        {
+        }
+        if (b == nullptr)
+            return allocate_block();
+        free_count_.fetch_sub(1, std::memory_order_relaxed);
+        b->next = nullptr;
+        return b;
+    }
+
+    // Called by the consumer only.
+    void put_block(block *b) noexcept
+    {
+        if (free_count_.load(std::memory_order_relaxed) >= detail::max_spare_blocks_v<T>)
+        {
+            deallocate_block(b);
+            return;
+        }
+        free_count_.fetch_add(1, std::memory_order_relaxed);
+        b->free_next = free_.load(std::memory_order_relaxed);
+        while (!free_.compare_exchange_weak(b->free_next, b, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // The slot of the next element to pop, moving on to the next block if
+    // the current one is used up. There must be an element.
+    T *front_slot() noexcept
+    {
+        if (head_ == block_size)
+        {
+            block *const old = head_block_;
+            head_block_ = old->next;
+            head_ = 0;
+            put_block(old);
+        }
+        return head_block_->slot(head_);
+    }
+
+    void pop_slot(T *p) noexcept
+    {
+        alloc_traits::destroy(alloc_, p);
+        ++head_;
+        popped_.store(++popped_local_, std::memory_order_release);
+    }
+
+  public:
+    spsc_deque() : spsc_deque(Allocator())
+    {
+    }
+
+    explicit spsc_deque(Allocator const &alloc) : alloc_(alloc)
+    {
+        head_block_ = tail_block_ = allocate_block();
+    }
+
+    spsc_deque(spsc_deque const &) = delete;
+    spsc_deque &operator=(spsc_deque const &) = delete;
+
+    ~spsc_deque()
+    {
+        auto const pushed = pushed_.load(std::memory_order_acquire);
+        while (popped_local_ != pushed)
+            pop_slot(front_slot());
+        for (block *b = head_block_; b != nullptr;)
+            deallocate_block(std::exchange(b, b->next));
+        for (block *b = free_.load(std::memory_order_acquire); b != nullptr;)
+            deallocate_block(std::exchange(b, b->free_next));
+    }
+
+    allocator_type get_allocator() const noexcept
+    {
+        return alloc_;
+    }
+
+    // Producer only.
+    template <class... Args>
+    void emplace_back(Args &&...args)
+    {
+        if (tail_ == block_size)
+        {
+            block *const b = take_block();
+            tail_block_->next = b;
+            tail_block_ = b;
+            tail_ = 0;
+        }
+        alloc_traits::construct(alloc_, tail_block_->slot(tail_), std::forward<Args>(args)...);
+        ++tail_;
+        pushed_.store(pushed_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    void push_back(T const &value)
+    {
+        emplace_back(value);
+    }
+
+    void push_back(T &&value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    // Consumer only. Moves the first element to out, if there is one.
+    bool try_pop_front(T &out)
+    {
+        if (popped_local_ == pushed_.load(std::memory_order_acquire))
+            return false;
+        T *const p = front_slot();
+        out = std::move(*p);
+        pop_slot(p);
+        return true;
+    }
+
+    std::optional<T> try_pop_front()
+    {
+        if (popped_local_ == pushed_.load(std::memory_order_acquire))
+            return std::nullopt;
+        T *const p = front_slot();
+        std::optional<T> out(std::move(*p));
+        pop_slot(p);
+        return out;
+    }
+
+    // Either thread; exact only while the other one is idle.
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    size_type size() const noexcept
+    {
+        auto const popped = popped_.load(std::memory_order_acquire);
+        return pushed_.load(std::memory_order_acquire) - popped;
+    }
+};
+
+} // namespace bizwen
+
+#endif // BIZWEN_DEQUE_HPP
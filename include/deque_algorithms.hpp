@@ -0,0 +1,502 @@
+#ifndef BIZWEN_DEQUE_ALGORITHMS_HPP
+#define BIZWEN_DEQUE_ALGORITHMS_HPP
+
+#include "deque.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+namespace bizwen
+{
+
+namespace detail
+{
+
+// The element at it as a raw pointer where the range is contiguous, and as
+// it otherwise.
+template <class I>
+constexpr auto chunk_begin(I const &it) noexcept
+{
+    if constexpr (is_deque_iterator_v<I> || std::contiguous_iterator<I>)
+        return raw_pointer(it);
+    else
+        return it;
+}
+
+// Walks n elements from each of its... in lockstep, calling
+// f(k, chunk_begin(its)...) for runs of k elements that are contiguous in
+// every deque, until f returns false.
+template <class F, class... I>
+constexpr void for_each_chunk(std::ptrdiff_t n, F &&f, I... its)
+{
+    while (n != 0)
+    {
+        auto const k = std::min({n, contiguous_after(its, n)...});
+        if (!f(k, chunk_begin(its)...))
+            return;
+        ((void)(its += k), ...);
+        n -= k;
+    }
+}
+
+} // namespace detail
+
+// Overloads of the std algorithms for deque iterators. They walk the range
+// one block at a time with raw pointers, which the compiler can vectorize,
+// and otherwise do what the std algorithm does.
+template <detail::deque_iterator_type I, class T>
+I find(I first, I last, T const &value)
+{
+    auto result = last;
+    detail::for_each_chunk(
+        last - first,
+        [&](std::ptrdiff_t k, auto p) {
+            auto const q = std::find(p, p + k, value);
+            first += q - p;
+            if (q == p + k)
+                return true;
+            result = first;
+            return false;
+        },
+        first);
+    return result;
+}
+
+template <detail::deque_iterator_type I, class Pred>
+I find_if(I first, I last, Pred pred)
+{
+    auto result = last;
+    detail::for_each_chunk(
+        last - first,
+        [&](std::ptrdiff_t k, auto p) {
+            auto const q = std::find_if(p, p + k, std::ref(pred));
+            first += q - p;
+            if (q == p + k)
+                return true;
+            result = first;
+            return false;
+        },
+        first);
+    return result;
+}
+
+template <detail::deque_iterator_type I, class T>
+std::iter_difference_t<I> count(I first, I last, T const &value)
+{
+    std::iter_difference_t<I> n = 0;
+    for (auto s : bizwen::segments(first, last))
+        n += static_cast<std::iter_difference_t<I>>(std::count(s.begin(), s.end(), value));
+    return n;
+}
+
+template <detail::deque_iterator_type I, class Pred>
+std::iter_difference_t<I> count_if(I first, I last, Pred pred)
+{
+    std::iter_difference_t<I> n = 0;
+    for (auto s : bizwen::segments(first, last))
+        n += static_cast<std::iter_difference_t<I>>(std::count_if(s.begin(), s.end(), std::ref(pred)));
+    return n;
+}
+
+template <detail::deque_iterator_type I, class T>
+void fill(I first, I last, T const &value)
+{
+    for (auto s : bizwen::segments(first, last))
+        std::fill(s.data(), s.data() + s.size(), value);
+}
+
+template <detail::deque_iterator_type I, class Size, class T>
+I fill_n(I first, Size n, T const &value)
+{
+    if (n <= 0)
+        return first;
+    auto const last = first + static_cast<std::iter_difference_t<I>>(n);
+    bizwen::fill(first, last, value);
+    return last;
+}
+
+template <detail::deque_iterator_type I, class F>
+F for_each(I first, I last, F f)
+{
+    for (auto s : bizwen::segments(first, last))
+        for (auto &elem : s)
+            f(elem);
+    return f;
+}
+
+template <detail::deque_iterator_type I, class T, class BinaryOp = std::plus<>>
+T accumulate(I first, I last, T init, BinaryOp op = BinaryOp())
+{
+    for (auto s : bizwen::segments(first, last))
+        for (auto const &elem : s)
+            init = op(std::move(init), elem);
+    return init;
+}
+
+template <detail::deque_iterator_type I, class T = std::iter_value_t<I>, class BinaryOp = std::plus<>>
+T reduce(I first, I last, T init = T(), BinaryOp op = BinaryOp())
+{
+    for (auto s : bizwen::segments(first, last))
+        init = std::reduce(s.data(), s.data() + s.size(), std::move(init), op);
+    return init;
+}
+
+namespace detail
+{
+
+// mismatch over n pairs, a pair of contiguous chunks at a time.
+template <class I1, class I2, class Pred>
+std::pair<I1, I2> mismatch_chunks(I1 first1, std::ptrdiff_t n, I2 first2, Pred &pred)
+{
+    detail::for_each_chunk(
+        n,
+        [&](std::ptrdiff_t k, auto p, auto q) {
+            auto const m = std::mismatch(p, p + k, q, std::ref(pred)).first - p;
+            first1 += m;
+            first2 += m;
+            return m == k;
+        },
+        first1, first2);
+    return {first1, first2};
+}
+
+// mismatch when only the first range is a deque and the second one can be
+// walked only once: the deque is walked a block at a time.
+template <class I1, class I2, class Pred>
+std::pair<I1, I2> mismatch_first(I1 first1, I1 last1, I2 first2, I2 last2, Pred &pred)
+{
+    detail::for_each_chunk(
+        last1 - first1,
+        [&](std::ptrdiff_t k, auto p) {
+            auto const r = std::mismatch(p, p + k, std::move(first2), last2, std::ref(pred));
+            first1 += r.first - p;
+            first2 = std::move(r.second);
+            return r.first == p + k;
+        },
+        first1);
+    return {first1, std::move(first2)};
+}
+
+template <class I1, class I2>
+concept mismatch_operands = is_deque_iterator_v<I1> || is_deque_iterator_v<I2>;
+
+} // namespace detail
+
+template <class I1, class I2, class Pred = std::equal_to<>>
+    requires detail::mismatch_operands<I1, I2>
+std::pair<I1, I2> mismatch(I1 first1, I1 last1, I2 first2, Pred pred = Pred())
+{
+    if constexpr (std::random_access_iterator<I1> && std::random_access_iterator<I2>)
+    {
+        return detail::mismatch_chunks(first1, last1 - first1, first2, pred);
+    }
+    else
+    {
+        for (; first1 != last1 && pred(*first1, *first2); ++first1, (void)++first2)
+        {
+        }
+        return {first1, first2};
+    }
+}
+
+template <class I1, class I2, class Pred = std::equal_to<>>
+    requires detail::mismatch_operands<I1, I2>
+std::pair<I1, I2> mismatch(I1 first1, I1 last1, I2 first2, I2 last2, Pred pred = Pred())
+{
+    if constexpr (std::random_access_iterator<I1> && std::random_access_iterator<I2>)
+    {
+        return detail::mismatch_chunks(first1, std::min<std::ptrdiff_t>(last1 - first1, last2 - first2), first2,
+                                       pred);
+    }
+    else if constexpr (detail::is_deque_iterator_v<I1>)
+    {
+        return detail::mismatch_first(first1, last1, std::move(first2), last2, pred);
+    }
+    else
+    {
+        for (; first1 != last1 && first2 != last2 && pred(*first1, *first2); ++first1, (void)++first2)
+        {
+        }
+        return {first1, first2};
+    }
+}
+
+namespace detail
+{
+
+inline constexpr std::ptrdiff_t insertion_sort_limit = 16;
+
+template <class I, class Compare>
+void insertion_sort(I first, I last, Compare &comp)
+{
+    if (first == last)
+        return;
+    for (auto i = std::next(first); i != last; ++i)
+    {
+        std::iter_value_t<I> value = std::move(*i);
+        auto j = i;
+        for (; j != first && comp(value, *std::prev(j)); --j)
+            *j = std::move(*std::prev(j));
+        *j = std::move(value);
+    }
+}
+
+// Destroys what a merge left in its buffer.
+template <class T>
+struct buffer_guard
+{
+    T *first;
+    T *last;
+
+    ~buffer_guard()
+    {
+        std::destroy(first, last);
+    }
+};
+
+// Merges the sorted runs [first, middle) and [middle, last) stably, in
+// place. The shorter run goes through buffer, room for buffer_size
+// elements, when it fits; otherwise both runs are split, the inner pieces
+// rotated past each other and the halves merged separately. Never
+// allocates.
+template <class I, class Compare, class T>
+void merge_adaptive(I first, I middle, I last, Compare &comp, T *buffer, std::ptrdiff_t buffer_size)
+{
+    auto len1 = middle - first;
+    auto len2 = last - middle;
+    while (len1 != 0 && len2 != 0)
+    {
+        if (!comp(*middle, *std::prev(middle)))
+            return;
+        if (len1 + len2 == 2)
+        {
+            std::iter_swap(first, middle);
+            return;
+        }
+        if (len1 <= len2 && len1 <= buffer_size)
+        {
+            buffer_guard<T> guard{buffer, std::uninitialized_move(first, middle, buffer)};
+            auto b = guard.first;
+            for (; b != guard.last && middle != last; ++first)
+            {
+                if (comp(*middle, *b))
+                    *first = std::move(*middle++);
+                else
+                    *first = std::move(*b++);
+            }
+            std::move(b, guard.last, first);
+            return;
+        }
+        if (len2 <= buffer_size)
+        {
+            buffer_guard<T> guard{buffer, std::uninitialized_move(middle, last, buffer)};
+            auto b = guard.last;
+            while (b != guard.first && middle != first)
+            {
+                if (comp(*std::prev(b), *std::prev(middle)))
+                    *--last = std::move(*--middle);
+                else
+                    *--last = std::move(*--b);
+            }
+            std::move_backward(guard.first, b, last);
+            return;
+        }
+        I cut1, cut2;
+        if (len1 > len2)
+        {
+            cut1 = first + len1 / 2;
+            cut2 = std::lower_bound(middle, last, *cut1, std::ref(comp));
+        }
+        else
+        {
+            cut2 = middle + len2 / 2;
+            cut1 = std::upper_bound(first, middle, *cut2, std::ref(comp));
+        }
+        auto const k1 = cut1 - first;
+        auto const k2 = cut2 - middle;
+        auto const new_middle = std::rotate(cut1, middle, cut2);
+        detail::merge_adaptive(first, cut1, new_middle, comp, buffer, buffer_size);
+        first = new_middle;
+        middle = cut2;
+        len1 -= k1;
+        len2 -= k2;
+    }
+}
+
+// A stable merge sort of a contiguous run that allocates nothing.
+template <class I, class Compare, class T>
+void merge_sort(I first, I last, Compare &comp, T *buffer, std::ptrdiff_t buffer_size)
+{
+    auto const n = last - first;
+    if (n <= insertion_sort_limit)
+    {
+        detail::insertion_sort(first, last, comp);
+        return;
+    }
+    auto const middle = first + n / 2;
+    detail::merge_sort(first, middle, comp, buffer, buffer_size);
+    detail::merge_sort(middle, last, comp, buffer, buffer_size);
+    detail::merge_adaptive(first, middle, last, comp, buffer, buffer_size);
+}
+
+// The block boundary nearest the middle of [first, last), which spans more
+// than one block.
+template <class I>
+I block_boundary(I first, I last) noexcept
+{
+    auto const middle = first + (last - first) / 2;
+    auto const b = deque_iterator_access::block_begin(middle, 0);
+    return b > first ? b : deque_iterator_access::block_begin(middle, 1);
+}
+
+// Sorts every block of [first, last) with raw pointers, and merges the
+// blocks pairwise, the halves split at block boundaries.
+template <bool Stable, class I, class Compare, class T>
+void sort_segments(I first, I last, Compare &comp, T *buffer, std::ptrdiff_t buffer_size)
+{
+    auto const n = last - first;
+    if (n < 2)
+        return;
+    if (contiguous_after(first, n) == n)
+    {
+        auto const p = raw_pointer(first);
+        if constexpr (Stable)
+            detail::merge_sort(p, p + n, comp, buffer, buffer_size);
+        else
+            std::sort(p, p + n, std::ref(comp));
+        return;
+    }
+    auto const middle = detail::block_boundary(first, last);
+    detail::sort_segments<Stable>(first, middle, comp, buffer, buffer_size);
+    detail::sort_segments<Stable>(middle, last, comp, buffer, buffer_size);
+    detail::merge_adaptive(first, middle, last, comp, buffer, buffer_size);
+}
+
+// A block of c lent as a merge buffer for the duration of a sort.
+template <class T, class Allocator>
+class borrowed_block
+{
+    deque<T, Allocator> &c_;
+    T *block_;
+
+  public:
+    borrowed_block(deque<T, Allocator> &c, bool allocate) : c_(c), block_(deque_access::borrow_block(c, allocate))
+    {
+    }
+
+    borrowed_block(borrowed_block const &) = delete;
+    borrowed_block &operator=(borrowed_block const &) = delete;
+
+    ~borrowed_block()
+    {
+        if (block_ != nullptr)
+            deque_access::return_block(c_, block_);
+    }
+
+    T *data() const noexcept
+    {
+        return block_;
+    }
+
+    std::ptrdiff_t size() const noexcept
+    {
+        return block_ == nullptr ? 0 : static_cast<std::ptrdiff_t>(block_elements_v<T>);
+    }
+};
+
+} // namespace detail
+
+// Sorts each block with raw pointers and then merges across blocks in place.
+// Neither allocates; the deque overloads merge through a spare block of the
+// deque when it has one, and stable_sort(c) allocates one block, freed before
+// it returns, when it has none.
+template <detail::deque_iterator_type I, class Compare = std::less<>>
+void sort(I first, I last, Compare comp = Compare())
+{
+    detail::sort_segments<false>(first, last, comp, static_cast<std::iter_value_t<I> *>(nullptr), 0);
+}
+
+template <detail::deque_iterator_type I, class Compare = std::less<>>
+void stable_sort(I first, I last, Compare comp = Compare())
+{
+    detail::sort_segments<true>(first, last, comp, static_cast<std::iter_value_t<I> *>(nullptr), 0);
+}
+
+template <class T, class Allocator, class Compare = std::less<>>
+void sort(deque<T, Allocator> &c, Compare comp = Compare())
+{
+    if (c.size() < 2)
+        return;
+    detail::borrowed_block<T, Allocator> buffer(c, false);
+    detail::sort_segments<false>(c.begin(), c.end(), comp, buffer.data(), buffer.size());
+}
+
+template <class T, class Allocator, class Compare = std::less<>>
+void stable_sort(deque<T, Allocator> &c, Compare comp = Compare())
+{
+    if (c.size() < 2)
+        return;
+    detail::borrowed_block<T, Allocator> buffer(c, true);
+    detail::sort_segments<true>(c.begin(), c.end(), comp, buffer.data(), buffer.size());
+}
+
+namespace detail
+{
+
+// The first element of [first, last) for which below is false, the range
+// being partitioned by below. Searches the blocks after the first one by
+// their first elements, and then the one block that can hold the answer.
+template <class I, class Pred>
+I partition_point_blocks(I first, I last, Pred below)
+{
+    if (first == last)
+        return first;
+    auto const blocks = deque_iterator_access::block_distance(first, std::prev(last)) + 1;
+    auto lo = std::ptrdiff_t{1};
+    auto hi = blocks;
+    while (lo < hi)
+    {
+        auto const mid = lo + (hi - lo) / 2;
+        if (below(*deque_iterator_access::block_begin(first, mid)))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    auto const b = lo == 1 ? first : deque_iterator_access::block_begin(first, lo - 1);
+    auto const e = lo == blocks ? last : deque_iterator_access::block_begin(first, lo);
+    auto const p = raw_pointer(b);
+    return b + (std::partition_point(p, p + (e - b), std::ref(below)) - p);
+}
+
+} // namespace detail
+
+// Binary searches in two steps: over the first elements of the blocks,
+// read through the map, and then with raw pointers within one block.
+template <detail::deque_iterator_type I, class T, class Compare = std::less<>>
+I lower_bound(I first, I last, T const &value, Compare comp = Compare())
+{
+    return detail::partition_point_blocks(first, last, [&](auto const &elem) { return comp(elem, value); });
+}
+
+template <detail::deque_iterator_type I, class T, class Compare = std::less<>>
+I upper_bound(I first, I last, T const &value, Compare comp = Compare())
+{
+    return detail::partition_point_blocks(first, last, [&](auto const &elem) { return !comp(value, elem); });
+}
+
+template <detail::deque_iterator_type I, class T, class Compare = std::less<>>
+std::pair<I, I> equal_range(I first, I last, T const &value, Compare comp = Compare())
+{
+    auto const lower = bizwen::lower_bound(first, last, value, comp);
+    return {lower, bizwen::upper_bound(lower, last, value, comp)};
+}
+
+} // namespace bizwen
+
+#endif // BIZWEN_DEQUE_ALGORITHMS_HPP
@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef TEST_SUPPORT_DEQUE_BLOCK_SIZE_H
+#define TEST_SUPPORT_DEQUE_BLOCK_SIZE_H
+
+#include <concepts>
+#include <cstddef>
+#include <vector>
+
+#include "deque.hpp"
+#include "test_macros.h"
+
+// The number of elements in one block of the deque C, as configured by
+// bizwen::deque_block_traits. make_deque<C>() uses it to place the first
+// element at a given offset inside its block.
+template <class C>
+TEST_CONSTEXPR int deque_block_elements() {
+  return static_cast<int>(bizwen::deque_block_traits<typename C::value_type>::block_elements);
+}
+
+// An int whose deques use blocks of exactly N elements, so that the tests
+// written against bizwen::deque<int> can be run across several block sizes.
+template <std::size_t N>
+struct block_int {
+  int value;
+
+  TEST_CONSTEXPR block_int(int v = 0) : value(v) {}
+
+  TEST_CONSTEXPR operator int() const { return value; }
+};
+
+namespace bizwen {
+template <std::size_t N>
+struct deque_block_traits<block_int<N> > {
+  static constexpr std::size_t block_elements = N;
+};
+} // namespace bizwen
+
+// Calls f.template operator()<C>() with C a deque of ints with the default
+// blocks and with blocks of 16 and 64 elements.
+template <class F>
+void for_each_block_size(F f) {
+  f.template operator()<bizwen::deque<int> >();
+  f.template operator()<bizwen::deque<block_int<16> > >();
+  f.template operator()<bizwen::deque<block_int<64> > >();
+}
+
+// A deque holding value(0), ..., value(size - 1), whose first element lies
+// start slots into its block, and which allocates with a.
+template <class C, class Value>
+  requires std::invocable<Value&, int>
+C make_deque(int size, int start, Value value, const typename C::allocator_type& a = typename C::allocator_type()) {
+  const int b = deque_block_elements<C>();
+  int init    = 0;
+  if (start > 0) {
+    init = (start + 1) / b + ((start + 1) % b != 0);
+    init *= b;
+    --init;
+  }
+  C c(init, typename C::value_type(), a);
+  for (int i = 0; i < init - start; ++i)
+    c.pop_back();
+  for (int i = 0; i < size; ++i)
+    c.push_back(value(i));
+  for (int i = 0; i < start; ++i)
+    c.pop_front();
+  return c;
+}
+
+// A deque holding 0, ..., size - 1.
+template <class C>
+C make_deque(int size, int start = 0) {
+  return make_deque<C>(size, start, [](int i) { return i; });
+}
+
+template <class C>
+C make_deque(int size, int start, const typename C::allocator_type& a) {
+  return make_deque<C>(size, start, [](int i) { return i; }, a);
+}
+
+// A deque holding the elements of v, whose first element lies start slots
+// into its block.
+template <class C>
+C make_deque(const std::vector<typename C::value_type>& v, int start) {
+  return make_deque<C>(static_cast<int>(v.size()), start, [&v](int i) { return v[i]; });
+}
+
+// Calls f(start, size) for the offsets of the first element and the sizes
+// around one and two blocks of 1024 elements that the tests are run with.
+template <class F>
+void for_each_deque_shape(F f) {
+  const int rng[] = {0, 1, 2, 3, 1023, 1024, 1025, 2047, 2048, 2049};
+  for (int start : rng)
+    for (int size : rng)
+      f(start, size);
+}
+
+// Calls f(first, last) for the subranges of [0, n) that begin and end at 0,
+// 1, n / 3, n / 2, n - 1 or n.
+template <class F>
+void for_each_subrange(int n, F f) {
+  const int offsets[] = {0, 1, n / 3, n / 2, n - 1, n};
+  for (int first : offsets)
+    for (int last : offsets)
+      if (first >= 0 && last <= n && first <= last)
+        f(first, last);
+}
+
+#endif // TEST_SUPPORT_DEQUE_BLOCK_SIZE_H